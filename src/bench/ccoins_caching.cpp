@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 #include <coins.h>
 #include <policy/policy.h>
+#include <random.h>
 #include <script/signingprovider.h>
 #include <test/util/transaction_utils.h>
 
@@ -52,3 +53,35 @@ static void CCoinsCaching(benchmark::Bench& bench)
 }
 
 BENCHMARK(CCoinsCaching);
+
+// Add, look up and spend coins the way connecting a block does, on a cache
+// large enough for its node allocations to matter.
+static void CCoinsCachingAddSpend(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_COINS = 10000;
+    FastRandomContext rng(/*fDeterministic=*/true);
+    std::vector<COutPoint> outpoints;
+    for (size_t i = 0; i < NUM_COINS; ++i) {
+        outpoints.emplace_back(rng.rand256(), rng.randrange(4));
+    }
+
+    const CScript script_pub_key = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0) << OP_EQUALVERIFY << OP_CHECKSIG;
+
+    CCoinsView coins_dummy;
+    bench.batch(NUM_COINS).unit("coin").run([&] {
+        CCoinsViewCache coins(&coins_dummy);
+        for (const COutPoint& outpoint : outpoints) {
+            Coin coin;
+            coin.out.nValue = 50 * COIN;
+            coin.out.scriptPubKey = script_pub_key;
+            coin.nHeight = 1;
+            coins.AddCoin(outpoint, std::move(coin), /*possible_overwrite=*/false);
+        }
+        for (const COutPoint& outpoint : outpoints) {
+            bool success = coins.HaveCoin(outpoint) && coins.SpendCoin(outpoint);
+            assert(success);
+        }
+    });
+}
+
+BENCHMARK(CCoinsCachingAddSpend);
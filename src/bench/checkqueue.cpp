@@ -20,11 +20,8 @@ static const unsigned int QUEUE_BATCH_SIZE = 128;
 // This Benchmark tests the CheckQueue with a slightly realistic workload,
 // where checks all contain a prevector that is indirect 50% of the time
 // and there is a little bit of work done between calls to Add.
-static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+static void RunCheckQueuePrevectorJob(benchmark::Bench& bench, int worker_threads)
 {
-    // We shouldn't ever be running with the checkqueue on a single core machine.
-    if (GetNumCores() <= 1) return;
-
     const ECCVerifyHandle verify_handle;
     ECC_Start();
 
@@ -42,9 +39,7 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
         void swap(PrevectorJob& x){p.swap(x.p);};
     };
     CCheckQueue<PrevectorJob> queue {QUEUE_BATCH_SIZE};
-    // The main thread should be counted to prevent thread oversubscription, and
-    // to decrease the variance of benchmark results.
-    queue.StartWorkerThreads(GetNumCores() - 1);
+    queue.StartWorkerThreads(worker_threads);
 
     // create all the data once, then submit copies in the benchmark.
     FastRandomContext insecure_rand(true);
@@ -68,4 +63,25 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     queue.StopWorkerThreads();
     ECC_Stop();
 }
+
+static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+{
+    // We shouldn't ever be running with the checkqueue on a single core machine.
+    if (GetNumCores() <= 1) return;
+    // The main thread should be counted to prevent thread oversubscription, and
+    // to decrease the variance of benchmark results.
+    RunCheckQueuePrevectorJob(bench, GetNumCores() - 1);
+}
+
+// Fixed thread counts, to compare how the queue scales across machines.
+// Counts above the number of cores measure oversubscription instead.
+static void CCheckQueueSpeedPrevectorJob8Threads(benchmark::Bench& bench) { RunCheckQueuePrevectorJob(bench, 7); }
+static void CCheckQueueSpeedPrevectorJob16Threads(benchmark::Bench& bench) { RunCheckQueuePrevectorJob(bench, 15); }
+static void CCheckQueueSpeedPrevectorJob32Threads(benchmark::Bench& bench) { RunCheckQueuePrevectorJob(bench, 31); }
+static void CCheckQueueSpeedPrevectorJob64Threads(benchmark::Bench& bench) { RunCheckQueuePrevectorJob(bench, 63); }
+
 BENCHMARK(CCheckQueueSpeedPrevectorJob);
+BENCHMARK(CCheckQueueSpeedPrevectorJob8Threads);
+BENCHMARK(CCheckQueueSpeedPrevectorJob16Threads);
+BENCHMARK(CCheckQueueSpeedPrevectorJob32Threads);
+BENCHMARK(CCheckQueueSpeedPrevectorJob64Threads);
@@ -5,6 +5,7 @@
 
 #include <bench/bench.h>
 #include <crypto/muhash.h>
+#include <crypto/scrypt.h>
 #include <crypto/ripemd160.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
@@ -72,6 +73,40 @@ static void SHA256D64_1024(benchmark::Bench& bench)
     });
 }
 
+static void SCRYPT_1024_1_1_256_GENERIC(benchmark::Bench& bench)
+{
+    std::vector<char> in(80, 0);
+    std::vector<char> out(32);
+    std::vector<char> scratchpad(SCRYPT_SCRATCHPAD_SIZE);
+    bench.unit("hash").run([&] {
+        scrypt_1024_1_1_256_sp_generic(in.data(), out.data(), scratchpad.data());
+    });
+}
+
+static void SCRYPT_1024_1_1_256(benchmark::Bench& bench)
+{
+    std::vector<char> in(80, 0);
+    std::vector<char> out(32);
+    bench.unit("hash").run([&] {
+        scrypt_1024_1_1_256(in.data(), out.data());
+    });
+}
+
+/* Batch sizes matching the widths of the multi-buffer kernels. Each case falls
+ * back to narrower kernels when the wider one is not supported by the CPU. */
+static void ScryptMulti(benchmark::Bench& bench, size_t n)
+{
+    std::vector<char> in(80 * n, 0);
+    std::vector<char> out(32 * n);
+    bench.batch(n).unit("hash").run([&] {
+        scrypt_1024_1_1_256_multi(in.data(), out.data(), n);
+    });
+}
+
+static void SCRYPT_1024_1_1_256_4WAY(benchmark::Bench& bench) { ScryptMulti(bench, 4); }
+static void SCRYPT_1024_1_1_256_8WAY(benchmark::Bench& bench) { ScryptMulti(bench, 8); }
+static void SCRYPT_1024_1_1_256_16WAY(benchmark::Bench& bench) { ScryptMulti(bench, 16); }
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -163,6 +198,11 @@ BENCHMARK(SHA3_256_1M);
 BENCHMARK(SHA256_32b);
 BENCHMARK(SipHash_32b);
 BENCHMARK(SHA256D64_1024);
+BENCHMARK(SCRYPT_1024_1_1_256_GENERIC);
+BENCHMARK(SCRYPT_1024_1_1_256);
+BENCHMARK(SCRYPT_1024_1_1_256_4WAY);
+BENCHMARK(SCRYPT_1024_1_1_256_8WAY);
+BENCHMARK(SCRYPT_1024_1_1_256_16WAY);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
 
@@ -0,0 +1,147 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <utility>
+#include <vector>
+
+// LevelDB workloads shaped like those of the chainstate and index databases,
+// run with different tunings (see -chainstatedb* and -indexdb*). The databases
+// are kept in memory, so that the results show the work LevelDB does rather
+// than the speed of the disk.
+
+//! Small enough for the write buffer to be written to table files several
+//! times per run.
+static constexpr size_t DB_CACHE_SIZE = 2 << 20;
+static constexpr size_t NUM_KEYS = 20000;
+static constexpr size_t BATCH_SIZE = 2000;
+
+// Coins: outpoint sized random keys with small values, of which some are
+// erased again as they are spent, and lookups that miss as often as they hit.
+static void ChainstateWorkload(benchmark::Bench& bench, const DBOptions& db_options)
+{
+    FastRandomContext rng(/*fDeterministic=*/true);
+    std::vector<std::pair<uint256, uint32_t>> keys, missing_keys;
+    std::vector<std::vector<unsigned char>> values;
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        keys.emplace_back(rng.rand256(), rng.randrange(4));
+        missing_keys.emplace_back(rng.rand256(), rng.randrange(4));
+        values.push_back(rng.randbytes(40));
+    }
+
+    bench.batch(NUM_KEYS).unit("coin").run([&] {
+        CDBWrapper db{"bench_chainstate", DB_CACHE_SIZE, /*fMemory=*/true, /*fWipe=*/false, /*obfuscate=*/true, db_options};
+        for (size_t i = 0; i < NUM_KEYS; i += BATCH_SIZE) {
+            CDBBatch batch(db);
+            for (size_t j = i; j < i + BATCH_SIZE; ++j) {
+                batch.Write(keys[j], values[j]);
+            }
+            // Spend a quarter of the coins of the previous batch.
+            for (size_t j = i > 0 ? i - BATCH_SIZE : i; j < i; j += 4) {
+                batch.Erase(keys[j]);
+            }
+            db.WriteBatch(batch);
+        }
+        std::vector<unsigned char> value;
+        for (size_t i = 0; i < NUM_KEYS; ++i) {
+            db.Read(keys[i], value);
+            db.Read(missing_keys[i], value);
+        }
+    });
+}
+
+// Indexes: random keys with larger, partly redundant values, written once
+// and looked up only when they exist.
+static void IndexWorkload(benchmark::Bench& bench, const DBOptions& db_options)
+{
+    FastRandomContext rng(/*fDeterministic=*/true);
+    std::vector<uint256> keys;
+    std::vector<std::vector<unsigned char>> values;
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        keys.push_back(rng.rand256());
+        std::vector<unsigned char> value = rng.randbytes(64);
+        value.resize(128);
+        values.push_back(std::move(value));
+    }
+
+    bench.batch(NUM_KEYS).unit("entry").run([&] {
+        CDBWrapper db{"bench_index", DB_CACHE_SIZE, /*fMemory=*/true, /*fWipe=*/false, /*obfuscate=*/false, db_options};
+        for (size_t i = 0; i < NUM_KEYS; i += BATCH_SIZE) {
+            CDBBatch batch(db);
+            for (size_t j = i; j < i + BATCH_SIZE; ++j) {
+                batch.Write(keys[j], values[j]);
+            }
+            db.WriteBatch(batch);
+        }
+        std::vector<unsigned char> value;
+        for (size_t i = 0; i < NUM_KEYS; ++i) {
+            db.Read(keys[i], value);
+        }
+    });
+}
+
+static void LevelDBChainstate(benchmark::Bench& bench)
+{
+    ChainstateWorkload(bench, {});
+}
+
+static void LevelDBChainstateNoBloom(benchmark::Bench& bench)
+{
+    DBOptions db_options;
+    db_options.bloom_bits = 0;
+    ChainstateWorkload(bench, db_options);
+}
+
+static void LevelDBChainstateLargeBlocks(benchmark::Bench& bench)
+{
+    DBOptions db_options;
+    db_options.block_size = 16 << 10;
+    ChainstateWorkload(bench, db_options);
+}
+
+static void LevelDBChainstateLargeWriteBuffer(benchmark::Bench& bench)
+{
+    DBOptions db_options;
+    db_options.write_buffer_size = 4 << 20;
+    ChainstateWorkload(bench, db_options);
+}
+
+static void LevelDBIndex(benchmark::Bench& bench)
+{
+    IndexWorkload(bench, {});
+}
+
+static void LevelDBIndexCompression(benchmark::Bench& bench)
+{
+    DBOptions db_options;
+    db_options.compression = true;
+    IndexWorkload(bench, db_options);
+}
+
+static void LevelDBIndexLargeBlocks(benchmark::Bench& bench)
+{
+    DBOptions db_options;
+    db_options.block_size = 16 << 10;
+    IndexWorkload(bench, db_options);
+}
+
+static void LevelDBIndexSmallFiles(benchmark::Bench& bench)
+{
+    DBOptions db_options;
+    db_options.max_file_size = 256 << 10;
+    IndexWorkload(bench, db_options);
+}
+
+BENCHMARK(LevelDBChainstate);
+BENCHMARK(LevelDBChainstateNoBloom);
+BENCHMARK(LevelDBChainstateLargeBlocks);
+BENCHMARK(LevelDBChainstateLargeWriteBuffer);
+BENCHMARK(LevelDBIndex);
+BENCHMARK(LevelDBIndexCompression);
+BENCHMARK(LevelDBIndexLargeBlocks);
+BENCHMARK(LevelDBIndexSmallFiles);
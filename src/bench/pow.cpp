@@ -0,0 +1,140 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <util/system.h>
+
+#include <vector>
+
+/* Number of headers in a full headers message, as received during header sync */
+static const size_t HEADERS_BATCH_SIZE = 2000;
+
+static std::vector<CBlockHeader> CreateHeaders(const CBlockHeader& genesis, size_t n)
+{
+    std::vector<CBlockHeader> headers(n, genesis);
+    for (size_t i = 0; i < n; ++i) {
+        headers[i].nNonce += i;
+    }
+    return headers;
+}
+
+static void BlockHeaderGetPoWHash(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::MAIN);
+    const CBlockHeader header = chainParams->GenesisBlock().GetBlockHeader();
+
+    bench.unit("header").run([&] {
+        uint256 hash = header.GetPoWHash();
+        ankerl::nanobench::doNotOptimizeAway(hash);
+    });
+}
+
+static void CheckProofOfWorkGenesis(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::MAIN);
+    const CBlockHeader header = chainParams->GenesisBlock().GetBlockHeader();
+    const uint256 hash = header.GetPoWHash();
+
+    bench.unit("header").run([&] {
+        bool checked = CheckProofOfWork(hash, header.nBits, chainParams->GetConsensus());
+        assert(checked);
+    });
+}
+
+/* Hash and check a full headers message one header at a time. */
+static void CheckHeadersPoWSerial(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::REGTEST);
+    const std::vector<CBlockHeader> headers = CreateHeaders(chainParams->GenesisBlock().GetBlockHeader(), HEADERS_BATCH_SIZE);
+
+    bench.batch(headers.size()).unit("header").run([&] {
+        size_t valid = 0;
+        for (const CBlockHeader& header : headers) {
+            valid += CheckProofOfWork(header.GetPoWHash(), header.nBits, chainParams->GetConsensus());
+        }
+        ankerl::nanobench::doNotOptimizeAway(valid);
+    });
+}
+
+/* Hash a full headers message with the multi-buffer scrypt kernels, then check it. */
+static void CheckHeadersPoWBatch(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::REGTEST);
+    const std::vector<CBlockHeader> headers = CreateHeaders(chainParams->GenesisBlock().GetBlockHeader(), HEADERS_BATCH_SIZE);
+
+    bench.batch(headers.size()).unit("header").run([&] {
+        const std::vector<uint256> hashes = GetPoWHashes(headers);
+        size_t valid = 0;
+        for (size_t i = 0; i < headers.size(); ++i) {
+            valid += CheckProofOfWork(hashes[i], headers[i].nBits, chainParams->GetConsensus());
+        }
+        ankerl::nanobench::doNotOptimizeAway(valid);
+    });
+}
+
+/* Number of consecutive headers to compute the next work for in each retarget regime */
+static const int NEXT_WORK_HEADERS = 1000;
+
+/* Mainnet-like block index up to just past the last difficulty algorithm change. */
+static const std::vector<CBlockIndex>& MainChain(const Consensus::Params& consensus)
+{
+    static std::vector<CBlockIndex> blocks = [&] {
+        const int num_blocks = consensus.nHeight_Difficulty_Version3 + NEXT_WORK_HEADERS + 1;
+        std::vector<CBlockIndex> chain(num_blocks);
+        for (int i = 0; i < num_blocks; i++) {
+            chain[i].pprev = i ? &chain[i - 1] : nullptr;
+            chain[i].nHeight = i;
+            chain[i].nTime = 1371488396 + i * consensus.nPowTargetSpacing + (i * 7) % consensus.nPowTargetSpacing;
+            chain[i].nBits = 0x1c0ffff0;
+            chain[i].BuildSkip();
+        }
+        return chain;
+    }();
+    return blocks;
+}
+
+/* Compute the next work for NEXT_WORK_HEADERS consecutive headers starting where
+ * the given difficulty algorithm version activates (for version 1, ending where
+ * version 2 activates). */
+static void GetNextWorkRequiredAt(benchmark::Bench& bench, int version)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::MAIN);
+    const Consensus::Params& consensus = chainParams->GetConsensus();
+    const std::vector<CBlockIndex>& blocks = MainChain(consensus);
+    const int height = version == 1 ? consensus.nHeight_Difficulty_Version2 - NEXT_WORK_HEADERS :
+                       version == 2 ? consensus.nHeight_Difficulty_Version2 :
+                                      consensus.nHeight_Difficulty_Version3;
+
+    bench.batch(NEXT_WORK_HEADERS).unit("header").run([&] {
+        unsigned int bits = 0;
+        for (int i = height; i < height + NEXT_WORK_HEADERS; i++) {
+            CBlockHeader header;
+            header.nTime = blocks[i].nTime;
+            bits ^= GetNextWorkRequired(&blocks[i - 1], &header, consensus);
+        }
+        ankerl::nanobench::doNotOptimizeAway(bits);
+    });
+}
+
+static void GetNextWorkRequiredV1(benchmark::Bench& bench) { GetNextWorkRequiredAt(bench, 1); }
+static void GetNextWorkRequiredV2(benchmark::Bench& bench) { GetNextWorkRequiredAt(bench, 2); }
+static void GetNextWorkRequiredV3(benchmark::Bench& bench) { GetNextWorkRequiredAt(bench, 3); }
+
+BENCHMARK(BlockHeaderGetPoWHash);
+BENCHMARK(CheckProofOfWorkGenesis);
+BENCHMARK(CheckHeadersPoWSerial);
+BENCHMARK(CheckHeadersPoWBatch);
+BENCHMARK(GetNextWorkRequiredV1);
+BENCHMARK(GetNextWorkRequiredV2);
+BENCHMARK(GetNextWorkRequiredV3);
@@ -5,6 +5,9 @@
 #include <bench/bench.h>
 #include <bench/data.h>
 
+#include <chainparams.h>
+#include <clientversion.h>
+#include <node/blockfilemap.h>
 #include <rpc/blockchain.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
@@ -58,3 +61,55 @@ static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
 }
 
 BENCHMARK(BlockToJsonVerboseWrite);
+
+namespace {
+
+/** The test block written to a block file, as getblock reads it. */
+struct TestBlockFile : public TestBlockAndIndex {
+    fs::path path;
+    long pos{8};
+
+    TestBlockFile()
+    {
+        path = testing_setup->m_args.GetDataDirNet() / "blk_bench.dat";
+        CAutoFile file(fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION);
+        file << Params().MessageStart() << (unsigned int)GetSerializeSize(block, CLIENT_VERSION) << block;
+    }
+};
+
+} // namespace
+
+// Latency of getblock (verbosity 1) for a block read with fopen/fseek/fread,
+// like ReadBlockFromDisk does without memory mapped block files.
+static void GetBlockFromFile(benchmark::Bench& bench)
+{
+    TestBlockFile data;
+    bench.run([&] {
+        CBlock block;
+        CAutoFile file(fsbridge::fopen(data.path, "rb"), SER_DISK, CLIENT_VERSION);
+        fseek(file.Get(), data.pos, SEEK_SET);
+        file >> block;
+        auto univalue = blockToJSON(block, &data.blockindex, &data.blockindex, /*verbose*/ false);
+        ankerl::nanobench::doNotOptimizeAway(univalue);
+    });
+}
+
+BENCHMARK(GetBlockFromFile);
+
+// Latency of getblock (verbosity 1) for a block read from a memory mapped block file.
+static void GetBlockFromMappedFile(benchmark::Bench& bench)
+{
+    TestBlockFile data;
+    MappedFileCache maps{1};
+    const size_t file_size = fs::file_size(data.path);
+    bench.run([&] {
+        CBlock block;
+        std::shared_ptr<const MappedFile> mapping = maps.Get(0, data.path, data.pos + 1, file_size);
+        assert(mapping);
+        SpanReader(SER_DISK, CLIENT_VERSION, mapping->data().subspan(data.pos)) >> block;
+        auto univalue = blockToJSON(block, &data.blockindex, &data.blockindex, /*verbose*/ false);
+        ankerl::nanobench::doNotOptimizeAway(univalue);
+    });
+}
+
+BENCHMARK(GetBlockFromMappedFile);
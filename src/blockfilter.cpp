@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
 #include <mutex>
 #include <sstream>
 #include <set>
@@ -22,6 +23,7 @@ static constexpr int GCS_SER_VERSION = 0;
 
 static const std::map<BlockFilterType, std::string> g_filter_types = {
     {BlockFilterType::BASIC, "basic"},
+    {BlockFilterType::FLODATA, "flodata"},
 };
 
 // Map a value x that is uniformly distributed in the range [0, 2^64) to a
@@ -249,6 +251,26 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
     return elements;
 }
 
+static GCSFilter::ElementSet FloDataFilterElements(const CBlock& block)
+{
+    GCSFilter::ElementSet elements;
+
+    for (const CTransactionRef& tx : block.vtx) {
+        const std::string& flo_data = tx->strFloData;
+        if (flo_data.empty()) continue;
+        const size_t prefix_size = std::min(flo_data.size(), FLODATA_FILTER_PREFIX_SIZE);
+        elements.emplace(flo_data.begin(), flo_data.begin() + prefix_size);
+
+        size_t tokens = 0;
+        for (size_t pos = flo_data.find(':'); pos < prefix_size && tokens < FLODATA_FILTER_MAX_TOKENS; pos = flo_data.find(':', pos + 1)) {
+            elements.emplace(flo_data.begin(), flo_data.begin() + pos + 1);
+            ++tokens;
+        }
+    }
+
+    return elements;
+}
+
 BlockFilter::BlockFilter(BlockFilterType filter_type, const uint256& block_hash,
                          std::vector<unsigned char> filter)
     : m_filter_type(filter_type), m_block_hash(block_hash)
@@ -267,13 +289,15 @@ BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const
     if (!BuildParams(params)) {
         throw std::invalid_argument("unknown filter_type");
     }
-    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    m_filter = GCSFilter(params, m_filter_type == BlockFilterType::FLODATA ? FloDataFilterElements(block)
+                                                                           : BasicFilterElements(block, block_undo));
 }
 
 bool BlockFilter::BuildParams(GCSFilter::Params& params) const
 {
     switch (m_filter_type) {
     case BlockFilterType::BASIC:
+    case BlockFilterType::FLODATA:
         params.m_siphash_k0 = m_block_hash.GetUint64(0);
         params.m_siphash_k1 = m_block_hash.GetUint64(1);
         params.m_P = BASIC_FILTER_P;
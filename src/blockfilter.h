@@ -85,9 +85,22 @@ public:
 constexpr uint8_t BASIC_FILTER_P = 19;
 constexpr uint32_t BASIC_FILTER_M = 784931;
 
+/** Number of leading floData bytes from which FLODATA filter elements are taken. */
+constexpr size_t FLODATA_FILTER_PREFIX_SIZE = 64;
+/** Maximum number of ':'-terminated prefixes of one floData added to a FLODATA filter. */
+constexpr size_t FLODATA_FILTER_MAX_TOKENS = 4;
+
 enum class BlockFilterType : uint8_t
 {
     BASIC = 0,
+    /**
+     * Flo-specific filter over the floData of the block's transactions. For each
+     * non-empty floData, its first FLODATA_FILTER_PREFIX_SIZE bytes are added,
+     * along with every prefix ending in ':' within them (up to
+     * FLODATA_FILTER_MAX_TOKENS), e.g. "text:" for "text:hello". Application
+     * prefixes of this form can thus be matched without downloading the block.
+     */
+    FLODATA = 0x80,
     INVALID = 255,
 };
 
@@ -13,6 +13,7 @@
 #include <tinyformat.h>
 #include <uint256.h>
 
+#include <algorithm>
 #include <vector>
 
 /**
@@ -127,8 +128,17 @@ enum BlockStatus: uint32_t {
     BLOCK_FAILED_MASK        =   BLOCK_FAILED_VALID | BLOCK_FAILED_CHILD,
 
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
+
+    BLOCK_HAVE_POW_HASH     =   256, //!< scrypt proof-of-work hash of the header is known (hashPoW)
 };
 
+/** Block index records stamped with this version or later may carry the scrypt
+ *  proof-of-work hash of their header. It is above the version of every client
+ *  that doesn't know the hash (22.99.0 and earlier), which keep the status bit
+ *  but drop the hash when they rewrite a record, so records are stamped with at
+ *  least this version. */
+static constexpr int DISK_BLOCK_INDEX_POW_HASH_VERSION = 229901;
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -193,6 +203,9 @@ public:
     uint32_t nBits{0};
     uint32_t nNonce{0};
 
+    //! scrypt proof-of-work hash of the block header, only valid if nStatus & BLOCK_HAVE_POW_HASH
+    uint256 hashPoW{};
+
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId{0};
 
@@ -248,6 +261,19 @@ public:
         return *phashBlock;
     }
 
+    //! Return the scrypt proof-of-work hash, only computing it if it is not stored
+    uint256 GetBlockPoWHash() const
+    {
+        if (nStatus & BLOCK_HAVE_POW_HASH) return hashPoW;
+        return GetBlockHeader().GetPoWHash();
+    }
+
+    void SetBlockPoWHash(const uint256& hash)
+    {
+        hashPoW = hash;
+        nStatus |= BLOCK_HAVE_POW_HASH;
+    }
+
     /**
      * Check whether this block's and all previous blocks' transactions have been
      * downloaded (and stored to disk) at some point.
@@ -346,6 +372,7 @@ public:
     SERIALIZE_METHODS(CDiskBlockIndex, obj)
     {
         int _nVersion = s.GetVersion();
+        SER_WRITE(obj, _nVersion = std::max(_nVersion, DISK_BLOCK_INDEX_POW_HASH_VERSION));
         if (!(s.GetType() & SER_GETHASH)) READWRITE(VARINT_MODE(_nVersion, VarIntMode::NONNEGATIVE_SIGNED));
 
         READWRITE(VARINT_MODE(obj.nHeight, VarIntMode::NONNEGATIVE_SIGNED));
@@ -362,6 +389,15 @@ public:
         READWRITE(obj.nTime);
         READWRITE(obj.nBits);
         READWRITE(obj.nNonce);
+
+        // Older clients leave unknown status bits alone but drop the hash
+        // when rewriting a record, so only trust the flag on newer records.
+        // Their records are stamped with their own, lower version.
+        if (_nVersion >= DISK_BLOCK_INDEX_POW_HASH_VERSION) {
+            if (obj.nStatus & BLOCK_HAVE_POW_HASH) READWRITE(obj.hashPoW);
+        } else {
+            SER_READ(obj, obj.nStatus &= ~BLOCK_HAVE_POW_HASH);
+        }
     }
 
     uint256 GetBlockHash() const
@@ -378,6 +414,8 @@ public:
 
     uint256 GetBlockPoWHash() const
     {
+        if (nStatus & BLOCK_HAVE_POW_HASH) return hashPoW;
+
         CBlockHeader block;
         block.nVersion        = nVersion;
         block.hashPrevBlock   = hashPrev;
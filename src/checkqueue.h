@@ -10,6 +10,11 @@
 #include <util/threadnames.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
 #include <vector>
 
 template <typename T>
@@ -24,12 +29,25 @@ class CCheckQueueControl;
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Every worker (including the master) has its own deque of checks. Each
+  * batch added by the master goes to the next deque in turn. A worker takes
+  * checks from the back of its own deque and, once that is empty, steals
+  * from the front of the others', so workers only contend on a deque lock
+  * while stealing. The shared mutex is only taken to go to sleep and to wake
+  * sleeping threads up.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
-    //! Mutex to protect the inner state
+    //! A worker's own checks, also stolen from by the other workers
+    struct WorkerDeque {
+        Mutex m_mutex;
+        std::deque<T> m_checks GUARDED_BY(m_mutex);
+    };
+
+    //! Mutex to protect the sleeping and waking of threads
     Mutex m_mutex;
 
     //! Worker threads block on this when out of work
@@ -38,94 +56,111 @@ private:
     //! Master thread blocks on this when out of work
     std::condition_variable m_master_cv;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue GUARDED_BY(m_mutex);
+    //! The deques of checks, one per worker thread plus one (the first) for the master.
+    //! Only resized when no worker threads are running.
+    std::vector<std::unique_ptr<WorkerDeque>> m_deques;
 
-    //! The number of workers (including the master) that are idle.
-    int nIdle GUARDED_BY(m_mutex){0};
+    //! The deque the next batch of checks is added to.
+    size_t m_next_deque{0};
 
-    //! The total number of workers (including the master).
-    int nTotal GUARDED_BY(m_mutex){0};
+    //! The number of checks in all deques.
+    std::atomic<unsigned int> m_queued{0};
 
-    //! The temporary evaluation result.
-    bool fAllOk GUARDED_BY(m_mutex){true};
+    //! The number of worker threads (excluding the master) that are asleep or about to be.
+    std::atomic<int> m_idle{0};
 
     /**
      * Number of verifications that haven't completed yet.
      * This includes elements that are no longer queued, but still in the
      * worker's own batches.
      */
-    unsigned int nTodo GUARDED_BY(m_mutex){0};
+    std::atomic<unsigned int> nTodo{0};
+
+    //! The temporary evaluation result.
+    std::atomic<bool> fAllOk{true};
 
-    //! The maximum number of elements to be processed in one batch
+    //! The maximum number of elements taken from a deque at once
     const unsigned int nBatchSize;
 
     std::vector<std::thread> m_worker_threads;
-    bool m_request_stop GUARDED_BY(m_mutex){false};
+    std::atomic<bool> m_request_stop{false};
+
+    /**
+     * Move up to half of the checks in a deque (at most nBatchSize) into vChecks,
+     * from the back of the worker's own deque or from the front of another's.
+     */
+    bool Take(WorkerDeque& deque, bool own, std::vector<T>& vChecks)
+    {
+        LOCK(deque.m_mutex);
+        if (deque.m_checks.empty()) return false;
+        const size_t nNow = std::min<size_t>(nBatchSize, (deque.m_checks.size() + 1) / 2);
+        vChecks.resize(nNow);
+        for (T& check : vChecks) {
+            // Swap instead of copying to keep the lock as short as possible.
+            if (own) {
+                check.swap(deque.m_checks.back());
+                deque.m_checks.pop_back();
+            } else {
+                check.swap(deque.m_checks.front());
+                deque.m_checks.pop_front();
+            }
+        }
+        m_queued -= nNow;
+        return true;
+    }
+
+    /** Take checks from the worker's own deque, or else steal them from another worker. */
+    bool TakeOrSteal(size_t index, std::vector<T>& vChecks)
+    {
+        if (Take(*m_deques[index], true, vChecks)) return true;
+        if (m_queued == 0) return false;
+        for (size_t i = 1; i < m_deques.size(); ++i) {
+            if (Take(*m_deques[(index + i) % m_deques.size()], false, vChecks)) return true;
+        }
+        return false;
+    }
 
     /** Internal function that does bulk of the verification work. */
-    bool Loop(bool fMaster)
+    bool Loop(size_t index)
     {
-        std::condition_variable& cond = fMaster ? m_master_cv : m_worker_cv;
+        const bool fMaster = index == 0;
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        bool fOk = true;
-        do {
-            {
+        while (true) {
+            if (m_request_stop) return false;
+            if (!TakeOrSteal(index, vChecks)) {
                 WAIT_LOCK(m_mutex, lock);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    fAllOk &= fOk;
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster)
-                        // We processed the last element; inform the master it can exit and return the result
-                        m_master_cv.notify_one();
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty() && !m_request_stop) {
-                    if (fMaster && nTodo == 0) {
-                        nTotal--;
-                        bool fRet = fAllOk;
-                        // reset the status for new work later
-                        fAllOk = true;
-                        // return the current status
-                        return fRet;
+                if (fMaster) {
+                    m_master_cv.wait(lock, [&] { return nTodo == 0 || m_queued > 0; });
+                    if (nTodo == 0) {
+                        // return the current status, and reset it for new work later
+                        return fAllOk.exchange(true);
                     }
-                    nIdle++;
-                    cond.wait(lock); // wait
-                    nIdle--;
-                }
-                if (m_request_stop) {
-                    return false;
-                }
-
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                vChecks.resize(nNow);
-                for (unsigned int i = 0; i < nNow; i++) {
-                    // We want the lock on the m_mutex to be as short as possible, so swap jobs from the global
-                    // queue to the local batch vector instead of copying.
-                    vChecks[i].swap(queue.back());
-                    queue.pop_back();
+                } else {
+                    // Announce going to sleep before the last check of m_queued, so
+                    // Add() either sees this worker idle or it finds the new checks.
+                    ++m_idle;
+                    m_worker_cv.wait(lock, [&] { return m_request_stop || m_queued > 0; });
+                    --m_idle;
                 }
-                // Check whether we need to do work at all
-                fOk = fAllOk;
+                continue;
             }
+
             // execute work
-            for (T& check : vChecks)
-                if (fOk)
-                    fOk = check();
+            bool fOk = fAllOk;
+            for (T& check : vChecks) {
+                if (fOk) fOk = check();
+            }
+            if (!fOk) fAllOk = false;
+            // Destroy the checks before they are reported as done, so none
+            // outlive the Wait() of their batch.
+            const unsigned int nNow = vChecks.size();
             vChecks.clear();
-        } while (true);
+            if (nTodo.fetch_sub(nNow) == nNow && !fMaster) {
+                // We processed the last element; inform the master it can exit and return the result
+                WITH_LOCK(m_mutex, m_master_cv.notify_one());
+            }
+        }
     }
 
 public:
@@ -136,22 +171,24 @@ public:
     explicit CCheckQueue(unsigned int nBatchSizeIn)
         : nBatchSize(nBatchSizeIn)
     {
+        m_deques.push_back(std::make_unique<WorkerDeque>());
     }
 
     //! Create a pool of new worker threads.
     void StartWorkerThreads(const int threads_num)
     {
-        {
-            LOCK(m_mutex);
-            nIdle = 0;
-            nTotal = 0;
-            fAllOk = true;
-        }
         assert(m_worker_threads.empty());
+        assert(nTodo == 0);
+        fAllOk = true;
+        m_deques.resize(1);
+        m_next_deque = 0;
+        for (int n = 0; n < threads_num; ++n) {
+            m_deques.push_back(std::make_unique<WorkerDeque>());
+        }
         for (int n = 0; n < threads_num; ++n) {
             m_worker_threads.emplace_back([this, n]() {
                 util::ThreadRename(strprintf("scriptch.%i", n));
-                Loop(false /* worker thread */);
+                Loop(n + 1 /* worker thread */);
             });
         }
     }
@@ -159,22 +196,33 @@ public:
     //! Wait until execution finishes, and return whether all evaluations were successful.
     bool Wait()
     {
-        return Loop(true /* master thread */);
+        return Loop(0 /* master thread */);
     }
 
     //! Add a batch of checks to the queue
     void Add(std::vector<T>& vChecks)
     {
-        LOCK(m_mutex);
-        for (T& check : vChecks) {
-            queue.push_back(T());
-            check.swap(queue.back());
-        }
+        if (vChecks.empty()) return;
         nTodo += vChecks.size();
-        if (vChecks.size() == 1)
-            m_worker_cv.notify_one();
-        else if (vChecks.size() > 1)
-            m_worker_cv.notify_all();
+        WorkerDeque& deque = *m_deques[m_next_deque];
+        m_next_deque = (m_next_deque + 1) % m_deques.size();
+        {
+            LOCK(deque.m_mutex);
+            for (T& check : vChecks) {
+                deque.m_checks.emplace_back();
+                check.swap(deque.m_checks.back());
+            }
+            m_queued += vChecks.size();
+        }
+        // Only wake as many sleeping workers as there are new checks. Notify
+        // under the lock, so a worker that found m_queued == 0 is asleep already.
+        const int nWake = std::min<int>(m_idle, vChecks.size());
+        if (nWake > 0) {
+            LOCK(m_mutex);
+            for (int i = 0; i < nWake; ++i) {
+                m_worker_cv.notify_one();
+            }
+        }
     }
 
     //! Stop all of the worker threads.
@@ -186,7 +234,7 @@ public:
             t.join();
         }
         m_worker_threads.clear();
-        WITH_LOCK(m_mutex, m_request_stop = false);
+        m_request_stop = false;
     }
 
     ~CCheckQueue()
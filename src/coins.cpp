@@ -9,6 +9,11 @@
 #include <random.h>
 #include <version.h>
 
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const { return false; }
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
@@ -31,7 +36,9 @@ bool CCoinsViewBacked::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock)
 std::unique_ptr<CCoinsViewCursor> CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0) {}
+CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn),
+    cacheCoins(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &m_cache_coins_memory_resource),
+    cachedCoinsUsage(0) {}
 
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
     return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
@@ -39,12 +46,17 @@ size_t CCoinsViewCache::DynamicMemoryUsage() const {
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
     CCoinsMap::iterator it = cacheCoins.find(outpoint);
-    if (it != cacheCoins.end())
+    if (it != cacheCoins.end()) {
+        ++m_stats.hits;
+        it->second.last_used = m_age;
         return it;
+    }
+    ++m_stats.misses;
     Coin tmp;
     if (!base->GetCoin(outpoint, tmp))
         return cacheCoins.end();
     CCoinsMap::iterator ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(tmp))).first;
+    ret->second.last_used = m_age;
     if (ret->second.coin.IsSpent()) {
         // The parent only has an empty entry for this outpoint; we can consider our
         // version as fresh.
@@ -94,6 +106,7 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
     }
     it->second.coin = std::move(coin);
     it->second.flags |= CCoinsCacheEntry::DIRTY | (fresh ? CCoinsCacheEntry::FRESH : 0);
+    it->second.last_used = m_age;
     cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
 }
 
@@ -105,6 +118,17 @@ void CCoinsViewCache::EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coi
         std::forward_as_tuple(std::move(coin), CCoinsCacheEntry::DIRTY));
 }
 
+void CCoinsViewCache::AddCoinFromBase(const COutPoint& outpoint, Coin&& coin) {
+    auto [it, inserted] = cacheCoins.try_emplace(outpoint, std::move(coin));
+    if (!inserted) return;
+    ++m_stats.warmed;
+    it->second.last_used = m_age;
+    if (it->second.coin.IsSpent()) {
+        it->second.flags = CCoinsCacheEntry::FRESH;
+    }
+    cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+}
+
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check_for_overwrite) {
     bool fCoinbase = tx.IsCoinBase();
     const uint256& txid = tx.GetHash();
@@ -180,6 +204,7 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                 entry.coin = std::move(it->second.coin);
                 cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
                 entry.flags = CCoinsCacheEntry::DIRTY;
+                entry.last_used = m_age;
                 // We can mark it FRESH in the parent if it was FRESH in the child
                 // Otherwise it might have just been flushed from the parent's cache
                 // and already exist in the grandparent
@@ -208,6 +233,7 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                 itUs->second.coin = std::move(it->second.coin);
                 cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
                 itUs->second.flags |= CCoinsCacheEntry::DIRTY;
+                itUs->second.last_used = m_age;
                 // NOTE: It isn't safe to mark the coin as FRESH in the parent
                 // cache. If it already existed and was spent in the parent
                 // cache then marking it FRESH would prevent that spentness
@@ -216,6 +242,7 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
         }
     }
     hashBlock = hashBlockIn;
+    ++m_age;
     return true;
 }
 
@@ -223,9 +250,77 @@ bool CCoinsViewCache::Flush() {
     bool fOk = base->BatchWrite(cacheCoins, hashBlock);
     cacheCoins.clear();
     cachedCoinsUsage = 0;
+    RecordFlush(0);
+    return fOk;
+}
+
+bool CCoinsViewCache::PartialFlush(size_t max_kept_usage) {
+    // Add up the memory the unspent coins use by age. Nodes come from the
+    // pool, so they cost their size, plus a share of the bucket array.
+    const size_t entry_usage = sizeof(CCoinsMap::value_type) + sizeof(void*) * 3;
+    std::map<uint32_t, std::pair<size_t, size_t>> usage_by_age; // usage and count
+    for (const auto& [outpoint, entry] : cacheCoins) {
+        if (entry.coin.IsSpent()) continue;
+        auto& [usage, count] = usage_by_age[m_age - entry.last_used];
+        usage += entry_usage + entry.coin.DynamicMemoryUsage();
+        ++count;
+    }
+
+    // Keep the most recently used coins that fit.
+    std::optional<uint32_t> max_kept_age;
+    size_t kept_usage = 0;
+    size_t kept_count = 0;
+    for (const auto& [age, usage_count] : usage_by_age) {
+        if (kept_usage + usage_count.first > max_kept_usage) break;
+        kept_usage += usage_count.first;
+        kept_count += usage_count.second;
+        max_kept_age = age;
+    }
+
+    // The kept coins are held next to the full cache until the batch is
+    // written, so memory use peaks at up to max_kept_usage above the cache
+    // size (plus the batch itself, if the base writes it in the background).
+    // Size the vector exactly, so that it does not add to the peak by growing.
+    std::vector<std::pair<COutPoint, CCoinsCacheEntry>> kept;
+    kept.reserve(kept_count);
+    for (CCoinsMap::iterator it = cacheCoins.begin(); it != cacheCoins.end();) {
+        CCoinsCacheEntry& entry = it->second;
+        if (!max_kept_age || entry.coin.IsSpent() || m_age - entry.last_used > *max_kept_age) {
+            ++it;
+        } else if (entry.flags & CCoinsCacheEntry::DIRTY) {
+            // The base still needs this one.
+            kept.emplace_back(it->first, CCoinsCacheEntry{Coin{entry.coin}});
+            kept.back().second.last_used = entry.last_used;
+            ++it;
+        } else {
+            kept.emplace_back(it->first, std::move(entry));
+            kept.back().second.flags = 0;
+            it = cacheCoins.erase(it);
+        }
+    }
+
+    bool fOk = base->BatchWrite(cacheCoins, hashBlock);
+    cacheCoins.clear();
+    // Rebuild the map, so that the memory of the coins not kept is released.
+    ReallocateCache();
+    cacheCoins.reserve(kept.size());
+    cachedCoinsUsage = 0;
+    for (auto& [outpoint, entry] : kept) {
+        cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
+        cacheCoins.emplace(outpoint, std::move(entry));
+    }
+    RecordFlush(kept.size());
     return fOk;
 }
 
+void CCoinsViewCache::RecordFlush(size_t coins_kept) {
+    m_stats.hits_before_flush = std::exchange(m_stats.hits, 0);
+    m_stats.misses_before_flush = std::exchange(m_stats.misses, 0);
+    m_stats.warmed_before_flush = std::exchange(m_stats.warmed, 0);
+    ++m_stats.flushes;
+    m_stats.coins_kept = coins_kept;
+}
+
 void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
     CCoinsMap::iterator it = cacheCoins.find(hash);
@@ -256,7 +351,9 @@ void CCoinsViewCache::ReallocateCache()
     // Cache should be empty when we're calling this.
     assert(cacheCoins.size() == 0);
     cacheCoins.~CCoinsMap();
-    ::new (&cacheCoins) CCoinsMap();
+    m_cache_coins_memory_resource.~CCoinsMapMemoryResource();
+    ::new (&m_cache_coins_memory_resource) CCoinsMapMemoryResource{};
+    ::new (&cacheCoins) CCoinsMap(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &m_cache_coins_memory_resource);
 }
 
 static const size_t MIN_TRANSACTION_OUTPUT_WEIGHT = WITNESS_SCALE_FACTOR * ::GetSerializeSize(CTxOut(), PROTOCOL_VERSION);
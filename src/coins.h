@@ -11,6 +11,7 @@
 #include <memusage.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/pool.h>
 #include <uint256.h>
 #include <util/hasher.h>
 
@@ -104,6 +105,8 @@ struct CCoinsCacheEntry
 {
     Coin coin; // The actual cached data.
     unsigned char flags;
+    //! Age of the cache when the entry was last used (see CCoinsViewCache::PartialFlush()).
+    uint32_t last_used{0};
 
     enum Flags {
         /**
@@ -131,7 +134,22 @@ struct CCoinsCacheEntry
     CCoinsCacheEntry(Coin&& coin_, unsigned char flag) : coin(std::move(coin_)), flags(flag) {}
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+/**
+ * The nodes of the map are allocated from a PoolResource, which saves a malloc
+ * per coin and lets memusage::DynamicUsage() account the map exactly. The size
+ * of a node is implementation defined; it is the key/value pair plus a next
+ * pointer and sometimes a cached hash, so four pointers of headroom make sure
+ * every standard library allocates its nodes from the pool.
+ */
+using CCoinsMap = std::unordered_map<COutPoint,
+                                     CCoinsCacheEntry,
+                                     SaltedOutpointHasher,
+                                     std::equal_to<COutPoint>,
+                                     PoolAllocator<std::pair<const COutPoint, CCoinsCacheEntry>,
+                                                   sizeof(std::pair<const COutPoint, CCoinsCacheEntry>) + sizeof(void*) * 4,
+                                                   alignof(void*)>>;
+
+using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -209,6 +227,23 @@ public:
 };
 
 
+/** Lookup statistics of a CCoinsViewCache, showing how well it is warmed up after flushes. */
+struct CCoinsCacheStats
+{
+    //! Lookups answered by the cache and lookups passed to its base since the last flush.
+    uint64_t hits{0};
+    uint64_t misses{0};
+    //! Coins added ahead of their lookups (see AddCoinFromBase()), whose lookups are then hits.
+    uint64_t warmed{0};
+    //! The same counts between the two most recent flushes.
+    uint64_t hits_before_flush{0};
+    uint64_t misses_before_flush{0};
+    uint64_t warmed_before_flush{0};
+    //! Number of flushes, and the number of coins the last one kept in the cache.
+    uint64_t flushes{0};
+    uint64_t coins_kept{0};
+};
+
 /** CCoinsView that adds a memory cache for transactions to another CCoinsView */
 class CCoinsViewCache : public CCoinsViewBacked
 {
@@ -218,11 +253,18 @@ protected:
      * declared as "const".
      */
     mutable uint256 hashBlock;
+    //! Backs the nodes of cacheCoins, so must be declared (and constructed) before it.
+    mutable CCoinsMapMemoryResource m_cache_coins_memory_resource{};
     mutable CCoinsMap cacheCoins;
 
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    //! Age of the cache, incremented with every block written to it.
+    uint32_t m_age{0};
+
+    mutable CCoinsCacheStats m_stats;
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -275,6 +317,14 @@ public:
      */
     void EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin);
 
+    /**
+     * Add a coin as read from the base view, as if it was fetched by a
+     * lookup. Has no effect if the cache already has an entry for the
+     * outpoint, whose version is the current one. Counted as warmed rather
+     * than as a miss in the stats.
+     */
+    void AddCoinFromBase(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
@@ -289,6 +339,15 @@ public:
      */
     bool Flush();
 
+    /**
+     * Push the modifications applied to this cache to its base like Flush(),
+     * but keep the most recently used unspent coins in the cache, as many as
+     * fit into max_kept_usage bytes. The coins kept are no longer modified, so
+     * they are as if just fetched from the base. Until the base has taken the
+     * modifications, memory use is up to max_kept_usage above the cache size.
+     */
+    bool PartialFlush(size_t max_kept_usage);
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
@@ -301,6 +360,8 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    CCoinsCacheStats GetStats() const { return m_stats; }
+
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
@@ -317,6 +378,8 @@ private:
      * memory usage.
      */
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
+
+    void RecordFlush(size_t coins_kept);
 };
 
 //! Utility function to add all of a transaction's outputs to a cache.
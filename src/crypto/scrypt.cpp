@@ -29,10 +29,24 @@
 
 #include <crypto/scrypt.h>
 
+#include <assert.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <new>
+#include <set>
+#include <vector>
+
+#include <compat/cpuid.h>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
 #include "openssl/sha.h"
 
 #if defined(USE_SSE2) && !defined(USE_SSE2_ALWAYS)
@@ -326,8 +340,313 @@ std::string scrypt_detect_sse2()
 }
 #endif
 
+namespace {
+
+/** Scratchpads at least this large are aligned to, and advised as, transparent huge pages. */
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+std::atomic<bool> g_huge_pages{DEFAULT_SCRYPT_HUGE_PAGES};
+
+/** Scratchpad size needed by a kernel hashing `ways` headers at once. */
+size_t ScratchpadSize(size_t ways)
+{
+    return 131072 * ways + 63;
+}
+
+/** Memory and hash counter owned by one thread. */
+class ScryptThreadState
+{
+public:
+    ScryptThreadState();
+    ~ScryptThreadState();
+
+    char* Scratchpad(size_t size);
+
+    std::string m_name;
+    std::atomic<uint64_t> m_hashes{0};
+
+private:
+    void Free();
+
+    char* m_base{nullptr};
+    size_t m_mapped{0};
+    char* m_data{nullptr};
+    size_t m_size{0};
+};
+
+std::mutex g_thread_states_mutex;
+std::set<const ScryptThreadState*> g_thread_states;
+//! Hashes computed by threads which have exited, per thread name.
+std::map<std::string, uint64_t> g_exited_hashes;
+
+ScryptThreadState::ScryptThreadState()
+{
+    std::lock_guard<std::mutex> lock(g_thread_states_mutex);
+    g_thread_states.insert(this);
+}
+
+ScryptThreadState::~ScryptThreadState()
+{
+    Free();
+    std::lock_guard<std::mutex> lock(g_thread_states_mutex);
+    g_thread_states.erase(this);
+    if (m_hashes) g_exited_hashes[m_name] += m_hashes;
+}
+
+char* ScryptThreadState::Scratchpad(size_t size)
+{
+    // The scratchpad only ever grows, since a smaller one is part of a larger one.
+    if (size <= m_size) return m_data;
+    Free();
+#ifndef WIN32
+    // Over-map so that large scratchpads can start on a huge page boundary.
+    const size_t extra = g_huge_pages && size >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : 0;
+    void* base = mmap(nullptr, size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) throw std::bad_alloc();
+    m_base = (char*)base;
+    m_mapped = size + extra;
+    m_data = m_base;
+    if (extra) {
+        m_data = (char*)(((uintptr_t)m_base + extra - 1) & ~(uintptr_t)(extra - 1));
+#ifdef MADV_HUGEPAGE
+        madvise(m_data, size, MADV_HUGEPAGE);
+#endif
+    }
+#else
+    m_base = new char[size + 63];
+    m_mapped = size + 63;
+    m_data = (char*)(((uintptr_t)m_base + 63) & ~(uintptr_t)63);
+#endif
+    m_size = size;
+    return m_data;
+}
+
+void ScryptThreadState::Free()
+{
+    if (!m_base) return;
+#ifndef WIN32
+    munmap(m_base, m_mapped);
+#else
+    delete[] m_base;
+#endif
+    m_base = m_data = nullptr;
+    m_mapped = m_size = 0;
+}
+
+ScryptThreadState& GetThreadState()
+{
+    static thread_local ScryptThreadState state;
+    return state;
+}
+
+} // namespace
+
+char *ScryptThreadScratchpad()
+{
+    // Anything smaller would be remapped, and the pointer invalidated, by the
+    // first multi-buffer hash on this thread.
+    return GetThreadState().Scratchpad(ScratchpadSize(16));
+}
+
+void ScryptSetHugePages(bool enable)
+{
+    g_huge_pages = enable;
+}
+
+void ScryptSetThreadName(const std::string& name)
+{
+    ScryptThreadState& state = GetThreadState();
+    std::lock_guard<std::mutex> lock(g_thread_states_mutex);
+    state.m_name = name;
+}
+
+std::map<std::string, uint64_t> ScryptGetHashCounts()
+{
+    std::lock_guard<std::mutex> lock(g_thread_states_mutex);
+    std::map<std::string, uint64_t> ret = g_exited_hashes;
+    for (const ScryptThreadState* state : g_thread_states) {
+        const uint64_t hashes = state->m_hashes.load(std::memory_order_relaxed);
+        if (hashes) ret[state->m_name] += hashes;
+    }
+    return ret;
+}
+
 void scrypt_1024_1_1_256(const char *input, char *output)
 {
-	char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
-    scrypt_1024_1_1_256_sp(input, output, scratchpad);
+    ScryptThreadState& state = GetThreadState();
+    scrypt_1024_1_1_256_sp(input, output, state.Scratchpad(SCRYPT_SCRATCHPAD_SIZE));
+    state.m_hashes.fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace scrypt_sse41
+{
+void scrypt_1024_1_1_256_sp_4way(const char *input, char *output, char *scratchpad);
+}
+
+namespace scrypt_avx2
+{
+void scrypt_1024_1_1_256_sp_8way(const char *input, char *output, char *scratchpad);
+}
+
+namespace scrypt_avx512
+{
+void scrypt_1024_1_1_256_sp_16way(const char *input, char *output, char *scratchpad);
+}
+
+namespace {
+
+typedef void (*ScryptMultiType)(const char *, char *, char *);
+
+ScryptMultiType scrypt_4way = nullptr;
+ScryptMultiType scrypt_8way = nullptr;
+ScryptMultiType scrypt_16way = nullptr;
+
+bool SelfTest()
+{
+    // Some arbitrary headers, and their hashes computed one at a time.
+    char input[16 * 80];
+    char expected[16 * 32];
+    char out[16 * 32];
+    for (int i = 0; i < 16 * 80; ++i) {
+        input[i] = (char)(i * 37 + (i >> 4));
+    }
+    for (int i = 0; i < 16; ++i) {
+        scrypt_1024_1_1_256(input + 80 * i, expected + 32 * i);
+    }
+    std::vector<char> scratchpad(ScratchpadSize(16));
+
+    // Test scrypt_4way, if available.
+    if (scrypt_4way) {
+        scrypt_4way(input, out, scratchpad.data());
+        if (memcmp(out, expected, 4 * 32)) return false;
+    }
+
+    // Test scrypt_8way, if available.
+    if (scrypt_8way) {
+        scrypt_8way(input, out, scratchpad.data());
+        if (memcmp(out, expected, 8 * 32)) return false;
+    }
+
+    // Test scrypt_16way, if available.
+    if (scrypt_16way) {
+        scrypt_16way(input, out, scratchpad.data());
+        if (memcmp(out, expected, 16 * 32)) return false;
+    }
+
+    return true;
+}
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/** Return the OS-enabled extended state components (XCR0). */
+uint32_t GetXCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a;
+}
+#endif
+} // namespace
+
+std::string ScryptAutoDetect()
+{
+    std::string ret = "generic";
+#if defined(USE_ASM) && defined(HAVE_GETCPUID)
+    bool have_sse4 = false;
+    bool have_xsave = false;
+    bool have_avx = false;
+    bool have_avx2 = false;
+    bool have_avx512 = false;
+    bool enabled_avx = false;
+    bool enabled_avx512 = false;
+
+    (void)GetXCR0;
+    (void)have_sse4;
+    (void)have_avx;
+    (void)have_xsave;
+    (void)have_avx2;
+    (void)have_avx512;
+    (void)enabled_avx;
+    (void)enabled_avx512;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    have_sse4 = (ecx >> 19) & 1;
+    have_xsave = (ecx >> 27) & 1;
+    have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        const uint32_t xcr0 = GetXCR0();
+        // SSE and AVX state, plus the opmask and ZMM register state for AVX-512.
+        enabled_avx = (xcr0 & 0x06) == 0x06;
+        enabled_avx512 = (xcr0 & 0xe6) == 0xe6;
+    }
+    if (have_sse4) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = (ebx >> 5) & 1;
+        have_avx512 = (ebx >> 16) & 1;
+    }
+
+#if defined(ENABLE_SSE41) && !defined(BUILD_FLOCOIN_INTERNAL)
+    if (have_sse4) {
+        scrypt_4way = scrypt_sse41::scrypt_1024_1_1_256_sp_4way;
+        ret += ",sse41(4way)";
+    }
+#endif
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_FLOCOIN_INTERNAL)
+    if (have_avx2 && have_avx && enabled_avx) {
+        scrypt_8way = scrypt_avx2::scrypt_1024_1_1_256_sp_8way;
+        ret += ",avx2(8way)";
+    }
+#endif
+
+#if defined(ENABLE_AVX512) && !defined(BUILD_FLOCOIN_INTERNAL)
+    if (have_avx512 && have_avx && enabled_avx512) {
+        scrypt_16way = scrypt_avx512::scrypt_1024_1_1_256_sp_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
+
+void scrypt_1024_1_1_256_multi(const char *inputs, char *outputs, size_t n)
+{
+    ScryptThreadState& state = GetThreadState();
+    const size_t total = n;
+    char *scratchpad = nullptr;
+    if (n >= 4) {
+        scratchpad = state.Scratchpad(ScratchpadSize(scrypt_16way ? 16 : scrypt_8way ? 8 : 4));
+    }
+    if (scrypt_16way) {
+        while (n >= 16) {
+            scrypt_16way(inputs, outputs, scratchpad);
+            inputs += 16 * 80;
+            outputs += 16 * 32;
+            n -= 16;
+        }
+    }
+    if (scrypt_8way) {
+        while (n >= 8) {
+            scrypt_8way(inputs, outputs, scratchpad);
+            inputs += 8 * 80;
+            outputs += 8 * 32;
+            n -= 8;
+        }
+    }
+    if (scrypt_4way) {
+        while (n >= 4) {
+            scrypt_4way(inputs, outputs, scratchpad);
+            inputs += 4 * 80;
+            outputs += 4 * 32;
+            n -= 4;
+        }
+    }
+    state.m_hashes.fetch_add(total - n, std::memory_order_relaxed);
+    while (n) {
+        scrypt_1024_1_1_256(inputs, outputs);
+        inputs += 80;
+        outputs += 32;
+        --n;
+    }
 }
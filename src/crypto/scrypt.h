@@ -3,12 +3,47 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <map>
+#include <string>
 
 static const int SCRYPT_SCRATCHPAD_SIZE = 131072 + 63;
+static const bool DEFAULT_SCRYPT_HUGE_PAGES = true;
 
 void scrypt_1024_1_1_256(const char *input, char *output);
 void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scratchpad);
 
+/** Autodetect the best available multi-buffer scrypt implementation.
+ *  Returns the name of the implementation.
+ */
+std::string ScryptAutoDetect();
+
+/** Compute multiple scrypt(N=1024, r=1, p=1) hashes of 80-byte block headers.
+ *  inputs:  pointer to a n*80 byte input buffer
+ *  outputs: pointer to a n*32 byte output buffer
+ *  n:       the number of hashes to compute.
+ */
+void scrypt_1024_1_1_256_multi(const char *inputs, char *outputs, size_t n);
+
+/** Return a 64-byte aligned scratchpad owned by the calling thread, for callers
+ *  which hash repeatedly. It is large enough for the widest kernel, is reused by
+ *  scrypt_1024_1_1_256() and scrypt_1024_1_1_256_multi() on the same thread, and
+ *  stays valid until the thread exits. The contents do not survive those calls.
+ */
+char *ScryptThreadScratchpad();
+
+/** Whether scratchpads of 2 MiB or more are aligned to, and advised as,
+ *  transparent huge pages. Only affects scratchpads allocated afterwards.
+ */
+void ScryptSetHugePages(bool enable);
+
+/** Set the name under which the calling thread's scrypt hashes are counted. */
+void ScryptSetThreadName(const std::string& name);
+
+/** Return the number of scrypt hashes computed so far per thread name, including
+ *  threads which have exited.
+ */
+std::map<std::string, uint64_t> ScryptGetHashCounts();
+
 #if defined(USE_SSE2)
 #include <string>
 #if defined(_M_X64) || defined(__x86_64__) || defined(_M_AMD64) || (defined(MAC_OSX) && defined(__i386__))
@@ -0,0 +1,103 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include <crypto/scrypt.h>
+
+namespace scrypt_avx2 {
+namespace {
+
+/** Number of independent scrypt instances processed in parallel, one per 32-bit lane. */
+constexpr int WAYS = 8;
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+/** Salsa20/8 core over eight interleaved states, word i of lane l in lane l of B[i]. */
+void inline XorSalsa8(__m256i B[16], const __m256i Bx[16])
+{
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) {
+        x[i] = B[i] = Xor(B[i], Bx[i]);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        /* Operate on columns. */
+        x[ 4] = Xor(x[ 4], RotL(Add(x[ 0], x[12]),  7)); x[ 9] = Xor(x[ 9], RotL(Add(x[ 5], x[ 1]),  7));
+        x[14] = Xor(x[14], RotL(Add(x[10], x[ 6]),  7)); x[ 3] = Xor(x[ 3], RotL(Add(x[15], x[11]),  7));
+        x[ 8] = Xor(x[ 8], RotL(Add(x[ 4], x[ 0]),  9)); x[13] = Xor(x[13], RotL(Add(x[ 9], x[ 5]),  9));
+        x[ 2] = Xor(x[ 2], RotL(Add(x[14], x[10]),  9)); x[ 7] = Xor(x[ 7], RotL(Add(x[ 3], x[15]),  9));
+        x[12] = Xor(x[12], RotL(Add(x[ 8], x[ 4]), 13)); x[ 1] = Xor(x[ 1], RotL(Add(x[13], x[ 9]), 13));
+        x[ 6] = Xor(x[ 6], RotL(Add(x[ 2], x[14]), 13)); x[11] = Xor(x[11], RotL(Add(x[ 7], x[ 3]), 13));
+        x[ 0] = Xor(x[ 0], RotL(Add(x[12], x[ 8]), 18)); x[ 5] = Xor(x[ 5], RotL(Add(x[ 1], x[13]), 18));
+        x[10] = Xor(x[10], RotL(Add(x[ 6], x[ 2]), 18)); x[15] = Xor(x[15], RotL(Add(x[11], x[ 7]), 18));
+
+        /* Operate on rows. */
+        x[ 1] = Xor(x[ 1], RotL(Add(x[ 0], x[ 3]),  7)); x[ 6] = Xor(x[ 6], RotL(Add(x[ 5], x[ 4]),  7));
+        x[11] = Xor(x[11], RotL(Add(x[10], x[ 9]),  7)); x[12] = Xor(x[12], RotL(Add(x[15], x[14]),  7));
+        x[ 2] = Xor(x[ 2], RotL(Add(x[ 1], x[ 0]),  9)); x[ 7] = Xor(x[ 7], RotL(Add(x[ 6], x[ 5]),  9));
+        x[ 8] = Xor(x[ 8], RotL(Add(x[11], x[10]),  9)); x[13] = Xor(x[13], RotL(Add(x[12], x[15]),  9));
+        x[ 3] = Xor(x[ 3], RotL(Add(x[ 2], x[ 1]), 13)); x[ 4] = Xor(x[ 4], RotL(Add(x[ 7], x[ 6]), 13));
+        x[ 9] = Xor(x[ 9], RotL(Add(x[ 8], x[11]), 13)); x[14] = Xor(x[14], RotL(Add(x[13], x[12]), 13));
+        x[ 0] = Xor(x[ 0], RotL(Add(x[ 3], x[ 2]), 18)); x[ 5] = Xor(x[ 5], RotL(Add(x[ 4], x[ 7]), 18));
+        x[10] = Xor(x[10], RotL(Add(x[ 9], x[ 8]), 18)); x[15] = Xor(x[15], RotL(Add(x[14], x[13]), 18));
+    }
+    for (int i = 0; i < 16; ++i) {
+        B[i] = Add(B[i], x[i]);
+    }
+}
+
+} // namespace
+
+void scrypt_1024_1_1_256_sp_8way(const char* input, char* output, char* scratchpad)
+{
+    uint8_t B[WAYS][128];
+    alignas(32) uint32_t lanes[WAYS];
+    __m256i X[32];
+    __m256i* V = (__m256i*)(((uintptr_t)(scratchpad) + 63) & ~(uintptr_t)(63));
+    const uint32_t* W = (const uint32_t*)V;
+
+    for (int l = 0; l < WAYS; ++l) {
+        PBKDF2_SHA256((const uint8_t*)input + 80 * l, 80, (const uint8_t*)input + 80 * l, 80, 1, B[l], 128);
+    }
+    for (int k = 0; k < 32; ++k) {
+        for (int l = 0; l < WAYS; ++l) lanes[l] = le32dec(&B[l][4 * k]);
+        X[k] = _mm256_load_si256((const __m256i*)lanes);
+    }
+
+    for (int i = 0; i < 1024; ++i) {
+        memcpy(&V[i * 32], X, sizeof(X));
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+    // Word k of lane l of scratchpad entry j lives at W[(j * 32 + k) * WAYS + l].
+    const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i mask = _mm256_set1_epi32(1023);
+    for (int i = 0; i < 1024; ++i) {
+        __m256i idx = Add(_mm256_slli_epi32(_mm256_and_si256(X[16], mask), 8), lane_offsets);
+        for (int k = 0; k < 32; ++k) {
+            X[k] = Xor(X[k], _mm256_i32gather_epi32((const int*)W, idx, 4));
+            idx = Add(idx, _mm256_set1_epi32(WAYS));
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+
+    for (int k = 0; k < 32; ++k) {
+        _mm256_store_si256((__m256i*)lanes, X[k]);
+        for (int l = 0; l < WAYS; ++l) le32enc(&B[l][4 * k], lanes[l]);
+    }
+    for (int l = 0; l < WAYS; ++l) {
+        PBKDF2_SHA256((const uint8_t*)input + 80 * l, 80, B[l], 128, 1, (uint8_t*)output + 32 * l, 32);
+    }
+}
+
+} // namespace scrypt_avx2
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include <crypto/scrypt.h>
+
+namespace scrypt_avx512 {
+namespace {
+
+/** Number of independent scrypt instances processed in parallel, one per 32-bit lane. */
+constexpr int WAYS = 16;
+
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+__m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+// The unmasked forms of VPROLD, VPSLLD and VPGATHERDD pass an undefined
+// vector to the builtin, which GCC 12 warns about. Full masks compile to the
+// same instructions.
+constexpr __mmask16 ALL_LANES = 0xFFFF;
+
+template <int N>
+__m512i inline RotL(__m512i x) { return _mm512_maskz_rol_epi32(ALL_LANES, x, N); }
+
+/** Salsa20/8 core over sixteen interleaved states, word i of lane l in lane l of B[i]. */
+void inline XorSalsa8(__m512i B[16], const __m512i Bx[16])
+{
+    __m512i x[16];
+    for (int i = 0; i < 16; ++i) {
+        x[i] = B[i] = Xor(B[i], Bx[i]);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        /* Operate on columns. */
+        x[ 4] = Xor(x[ 4], RotL<7>(Add(x[ 0], x[12]))); x[ 9] = Xor(x[ 9], RotL<7>(Add(x[ 5], x[ 1])));
+        x[14] = Xor(x[14], RotL<7>(Add(x[10], x[ 6]))); x[ 3] = Xor(x[ 3], RotL<7>(Add(x[15], x[11])));
+        x[ 8] = Xor(x[ 8], RotL<9>(Add(x[ 4], x[ 0]))); x[13] = Xor(x[13], RotL<9>(Add(x[ 9], x[ 5])));
+        x[ 2] = Xor(x[ 2], RotL<9>(Add(x[14], x[10]))); x[ 7] = Xor(x[ 7], RotL<9>(Add(x[ 3], x[15])));
+        x[12] = Xor(x[12], RotL<13>(Add(x[ 8], x[ 4]))); x[ 1] = Xor(x[ 1], RotL<13>(Add(x[13], x[ 9])));
+        x[ 6] = Xor(x[ 6], RotL<13>(Add(x[ 2], x[14]))); x[11] = Xor(x[11], RotL<13>(Add(x[ 7], x[ 3])));
+        x[ 0] = Xor(x[ 0], RotL<18>(Add(x[12], x[ 8]))); x[ 5] = Xor(x[ 5], RotL<18>(Add(x[ 1], x[13])));
+        x[10] = Xor(x[10], RotL<18>(Add(x[ 6], x[ 2]))); x[15] = Xor(x[15], RotL<18>(Add(x[11], x[ 7])));
+
+        /* Operate on rows. */
+        x[ 1] = Xor(x[ 1], RotL<7>(Add(x[ 0], x[ 3]))); x[ 6] = Xor(x[ 6], RotL<7>(Add(x[ 5], x[ 4])));
+        x[11] = Xor(x[11], RotL<7>(Add(x[10], x[ 9]))); x[12] = Xor(x[12], RotL<7>(Add(x[15], x[14])));
+        x[ 2] = Xor(x[ 2], RotL<9>(Add(x[ 1], x[ 0]))); x[ 7] = Xor(x[ 7], RotL<9>(Add(x[ 6], x[ 5])));
+        x[ 8] = Xor(x[ 8], RotL<9>(Add(x[11], x[10]))); x[13] = Xor(x[13], RotL<9>(Add(x[12], x[15])));
+        x[ 3] = Xor(x[ 3], RotL<13>(Add(x[ 2], x[ 1]))); x[ 4] = Xor(x[ 4], RotL<13>(Add(x[ 7], x[ 6])));
+        x[ 9] = Xor(x[ 9], RotL<13>(Add(x[ 8], x[11]))); x[14] = Xor(x[14], RotL<13>(Add(x[13], x[12])));
+        x[ 0] = Xor(x[ 0], RotL<18>(Add(x[ 3], x[ 2]))); x[ 5] = Xor(x[ 5], RotL<18>(Add(x[ 4], x[ 7])));
+        x[10] = Xor(x[10], RotL<18>(Add(x[ 9], x[ 8]))); x[15] = Xor(x[15], RotL<18>(Add(x[14], x[13])));
+    }
+    for (int i = 0; i < 16; ++i) {
+        B[i] = Add(B[i], x[i]);
+    }
+}
+
+} // namespace
+
+void scrypt_1024_1_1_256_sp_16way(const char* input, char* output, char* scratchpad)
+{
+    uint8_t B[WAYS][128];
+    alignas(64) uint32_t lanes[WAYS];
+    __m512i X[32];
+    __m512i* V = (__m512i*)(((uintptr_t)(scratchpad) + 63) & ~(uintptr_t)(63));
+    const uint32_t* W = (const uint32_t*)V;
+
+    for (int l = 0; l < WAYS; ++l) {
+        PBKDF2_SHA256((const uint8_t*)input + 80 * l, 80, (const uint8_t*)input + 80 * l, 80, 1, B[l], 128);
+    }
+    for (int k = 0; k < 32; ++k) {
+        for (int l = 0; l < WAYS; ++l) lanes[l] = le32dec(&B[l][4 * k]);
+        X[k] = _mm512_load_si512((const __m512i*)lanes);
+    }
+
+    for (int i = 0; i < 1024; ++i) {
+        memcpy(&V[i * 32], X, sizeof(X));
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+    // Word k of lane l of scratchpad entry j lives at W[(j * 32 + k) * WAYS + l].
+    const __m512i lane_offsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i mask = _mm512_set1_epi32(1023);
+    for (int i = 0; i < 1024; ++i) {
+        __m512i idx = Add(_mm512_maskz_slli_epi32(ALL_LANES, _mm512_and_si512(X[16], mask), 9), lane_offsets);
+        for (int k = 0; k < 32; ++k) {
+            X[k] = Xor(X[k], _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ALL_LANES, idx, W, 4));
+            idx = Add(idx, _mm512_set1_epi32(WAYS));
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+
+    for (int k = 0; k < 32; ++k) {
+        _mm512_store_si512((__m512i*)lanes, X[k]);
+        for (int l = 0; l < WAYS; ++l) le32enc(&B[l][4 * k], lanes[l]);
+    }
+    for (int l = 0; l < WAYS; ++l) {
+        PBKDF2_SHA256((const uint8_t*)input + 80 * l, 80, B[l], 128, 1, (uint8_t*)output + 32 * l, 32);
+    }
+}
+
+} // namespace scrypt_avx512
+
+#endif
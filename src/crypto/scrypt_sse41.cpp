@@ -0,0 +1,103 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_SSE41
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include <crypto/scrypt.h>
+
+namespace scrypt_sse41 {
+namespace {
+
+/** Number of independent scrypt instances processed in parallel, one per 32-bit lane. */
+constexpr int WAYS = 4;
+
+__m128i inline Add(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+__m128i inline RotL(__m128i x, int n) { return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n)); }
+
+/** Salsa20/8 core over four interleaved states, word i of lane l in lane l of B[i]. */
+void inline XorSalsa8(__m128i B[16], const __m128i Bx[16])
+{
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) {
+        x[i] = B[i] = Xor(B[i], Bx[i]);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        /* Operate on columns. */
+        x[ 4] = Xor(x[ 4], RotL(Add(x[ 0], x[12]),  7)); x[ 9] = Xor(x[ 9], RotL(Add(x[ 5], x[ 1]),  7));
+        x[14] = Xor(x[14], RotL(Add(x[10], x[ 6]),  7)); x[ 3] = Xor(x[ 3], RotL(Add(x[15], x[11]),  7));
+        x[ 8] = Xor(x[ 8], RotL(Add(x[ 4], x[ 0]),  9)); x[13] = Xor(x[13], RotL(Add(x[ 9], x[ 5]),  9));
+        x[ 2] = Xor(x[ 2], RotL(Add(x[14], x[10]),  9)); x[ 7] = Xor(x[ 7], RotL(Add(x[ 3], x[15]),  9));
+        x[12] = Xor(x[12], RotL(Add(x[ 8], x[ 4]), 13)); x[ 1] = Xor(x[ 1], RotL(Add(x[13], x[ 9]), 13));
+        x[ 6] = Xor(x[ 6], RotL(Add(x[ 2], x[14]), 13)); x[11] = Xor(x[11], RotL(Add(x[ 7], x[ 3]), 13));
+        x[ 0] = Xor(x[ 0], RotL(Add(x[12], x[ 8]), 18)); x[ 5] = Xor(x[ 5], RotL(Add(x[ 1], x[13]), 18));
+        x[10] = Xor(x[10], RotL(Add(x[ 6], x[ 2]), 18)); x[15] = Xor(x[15], RotL(Add(x[11], x[ 7]), 18));
+
+        /* Operate on rows. */
+        x[ 1] = Xor(x[ 1], RotL(Add(x[ 0], x[ 3]),  7)); x[ 6] = Xor(x[ 6], RotL(Add(x[ 5], x[ 4]),  7));
+        x[11] = Xor(x[11], RotL(Add(x[10], x[ 9]),  7)); x[12] = Xor(x[12], RotL(Add(x[15], x[14]),  7));
+        x[ 2] = Xor(x[ 2], RotL(Add(x[ 1], x[ 0]),  9)); x[ 7] = Xor(x[ 7], RotL(Add(x[ 6], x[ 5]),  9));
+        x[ 8] = Xor(x[ 8], RotL(Add(x[11], x[10]),  9)); x[13] = Xor(x[13], RotL(Add(x[12], x[15]),  9));
+        x[ 3] = Xor(x[ 3], RotL(Add(x[ 2], x[ 1]), 13)); x[ 4] = Xor(x[ 4], RotL(Add(x[ 7], x[ 6]), 13));
+        x[ 9] = Xor(x[ 9], RotL(Add(x[ 8], x[11]), 13)); x[14] = Xor(x[14], RotL(Add(x[13], x[12]), 13));
+        x[ 0] = Xor(x[ 0], RotL(Add(x[ 3], x[ 2]), 18)); x[ 5] = Xor(x[ 5], RotL(Add(x[ 4], x[ 7]), 18));
+        x[10] = Xor(x[10], RotL(Add(x[ 9], x[ 8]), 18)); x[15] = Xor(x[15], RotL(Add(x[14], x[13]), 18));
+    }
+    for (int i = 0; i < 16; ++i) {
+        B[i] = Add(B[i], x[i]);
+    }
+}
+
+} // namespace
+
+void scrypt_1024_1_1_256_sp_4way(const char* input, char* output, char* scratchpad)
+{
+    uint8_t B[WAYS][128];
+    alignas(16) uint32_t lanes[WAYS];
+    __m128i X[32];
+    __m128i* V = (__m128i*)(((uintptr_t)(scratchpad) + 63) & ~(uintptr_t)(63));
+    const uint32_t* W = (const uint32_t*)V;
+
+    for (int l = 0; l < WAYS; ++l) {
+        PBKDF2_SHA256((const uint8_t*)input + 80 * l, 80, (const uint8_t*)input + 80 * l, 80, 1, B[l], 128);
+    }
+    for (int k = 0; k < 32; ++k) {
+        for (int l = 0; l < WAYS; ++l) lanes[l] = le32dec(&B[l][4 * k]);
+        X[k] = _mm_load_si128((const __m128i*)lanes);
+    }
+
+    for (int i = 0; i < 1024; ++i) {
+        memcpy(&V[i * 32], X, sizeof(X));
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+    for (int i = 0; i < 1024; ++i) {
+        const uint32_t j0 = 32 * WAYS * (_mm_extract_epi32(X[16], 0) & 1023);
+        const uint32_t j1 = 32 * WAYS * (_mm_extract_epi32(X[16], 1) & 1023);
+        const uint32_t j2 = 32 * WAYS * (_mm_extract_epi32(X[16], 2) & 1023);
+        const uint32_t j3 = 32 * WAYS * (_mm_extract_epi32(X[16], 3) & 1023);
+        for (int k = 0; k < 32; ++k) {
+            const int o = k * WAYS;
+            X[k] = Xor(X[k], _mm_set_epi32(W[j3 + o + 3], W[j2 + o + 2], W[j1 + o + 1], W[j0 + o]));
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+
+    for (int k = 0; k < 32; ++k) {
+        _mm_store_si128((__m128i*)lanes, X[k]);
+        for (int l = 0; l < WAYS; ++l) le32enc(&B[l][4 * k], lanes[l]);
+    }
+    for (int l = 0; l < WAYS; ++l) {
+        PBKDF2_SHA256((const uint8_t*)input + 80 * l, 80, B[l], 128, 1, (uint8_t*)output + 32 * l, 32);
+    }
+}
+
+} // namespace scrypt_sse41
+
+#endif
@@ -97,13 +97,18 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBOptions& db_options)
 {
     leveldb::Options options;
     options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.compression = leveldb::kNoCompression;
+    // up to two write buffers may be held in memory simultaneously
+    options.write_buffer_size = db_options.write_buffer_size > 0 ? db_options.write_buffer_size : nCacheSize / 4;
+    if (db_options.block_size > 0) options.block_size = db_options.block_size;
+    if (db_options.max_file_size > 0) options.max_file_size = db_options.max_file_size;
+    if (db_options.bloom_bits > 0) {
+        options.filter_policy = leveldb::NewBloomFilterPolicy(std::min(db_options.bloom_bits, MAX_DB_BLOOM_BITS));
+    }
+    options.compression = db_options.compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
     options.info_log = new CFlocoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -111,10 +116,24 @@ static leveldb::Options GetOptions(size_t nCacheSize)
         options.paranoid_checks = true;
     }
     SetMaxOpenFiles(&options);
+    LogPrint(BCLog::LEVELDB, "LevelDB using write_buffer_size=%u block_size=%u max_file_size=%u bloom_bits=%d compression=%d\n",
+             options.write_buffer_size, options.block_size, options.max_file_size, options.filter_policy ? db_options.bloom_bits : 0, db_options.compression);
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+DBOptions ReadDBOptions(const ArgsManager& args, const std::string& name)
+{
+    DBOptions db_options;
+    const std::string prefix = "-" + name + "db";
+    db_options.write_buffer_size = std::max<int64_t>(0, args.GetArg(prefix + "writebuffer", 0)) << 20;
+    db_options.block_size = std::max<int64_t>(0, args.GetArg(prefix + "blocksize", 0)) << 10;
+    db_options.bloom_bits = std::clamp<int64_t>(args.GetArg(prefix + "bloombits", db_options.bloom_bits), 0, MAX_DB_BLOOM_BITS);
+    db_options.compression = args.GetBoolArg(prefix + "compression", db_options.compression);
+    db_options.max_file_size = std::max<int64_t>(0, args.GetArg(prefix + "filesize", 0)) << 20;
+    return db_options;
+}
+
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const DBOptions& db_options)
     : m_name{path.stem().string()}
 {
     penv = nullptr;
@@ -122,7 +141,7 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, db_options);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
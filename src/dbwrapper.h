@@ -19,6 +19,37 @@
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
+/**
+ * LevelDB tuning of a database. Zero sizes leave the value to be derived
+ * from the cache size or to LevelDB's default.
+ */
+struct DBOptions {
+    //! Bytes of writes to keep in memory before writing a sorted table file.
+    //! Up to two write buffers may be held in memory simultaneously. Zero
+    //! for a quarter of the cache size.
+    size_t write_buffer_size{0};
+    //! Uncompressed size of the data blocks that are read and cached as a unit.
+    size_t block_size{0};
+    //! Bits per key of the bloom filter that saves reads of missing keys,
+    //! 0 for no filter.
+    int bloom_bits{10};
+    //! Compress the data blocks with Snappy.
+    bool compression{false};
+    //! Size at which table files are split. Larger files mean fewer but
+    //! larger compactions.
+    size_t max_file_size{0};
+};
+
+//! Number of bloom filter bits per key above which a filter doesn't get better.
+static const int MAX_DB_BLOOM_BITS = 32;
+
+/**
+ * Read the tuning of a database from the -<name>db... startup options:
+ * -<name>dbwritebuffer and -<name>dbfilesize in MiB, -<name>dbblocksize in
+ * KiB, -<name>dbbloombits and -<name>dbcompression.
+ */
+DBOptions ReadDBOptions(const ArgsManager& args, const std::string& name);
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -220,8 +251,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] db_options  LevelDB tuning of the database.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const DBOptions& db_options = {});
     ~CDBWrapper();
 
     CDBWrapper(const CDBWrapper&) = delete;
@@ -4,6 +4,7 @@
 
 #include <chainparams.h>
 #include <index/base.h>
+#include <node/blockprefetcher.h>
 #include <node/blockstorage.h>
 #include <node/ui_interface.h>
 #include <shutdown.h>
@@ -29,7 +30,7 @@ static void FatalError(const char* fmt, const Args&... args)
 }
 
 BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool f_wipe, bool f_obfuscate) :
-    CDBWrapper(path, n_cache_size, f_memory, f_wipe, f_obfuscate)
+    CDBWrapper(path, n_cache_size, f_memory, f_wipe, f_obfuscate, ReadDBOptions(gArgs, "index"))
 {}
 
 bool BaseIndex::DB::ReadBestBlock(CBlockLocator& locator) const
@@ -129,6 +130,10 @@ void BaseIndex::ThreadSync()
 
         int64_t last_log_time = 0;
         int64_t last_locator_write_time = 0;
+        std::unique_ptr<BlockPrefetcher> prefetcher;
+        if (g_block_prefetch > 0) {
+            prefetcher = std::make_unique<BlockPrefetcher>(consensus_params, BLOCK_PREFETCH_THREADS);
+        }
         while (true) {
             if (m_interrupt) {
                 m_best_block_index = pindex;
@@ -155,6 +160,7 @@ void BaseIndex::ThreadSync()
                     return;
                 }
                 pindex = pindex_next;
+                if (prefetcher) prefetcher->Prefetch(m_chainstate->m_chain, pindex, g_block_prefetch);
             }
 
             int64_t current_time = GetTime();
@@ -171,13 +177,17 @@ void BaseIndex::ThreadSync()
                 Commit();
             }
 
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
-                FatalError("%s: Failed to read block %s from disk",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
+            std::shared_ptr<const CBlock> block = prefetcher ? prefetcher->Get(pindex->GetBlockHash()) : nullptr;
+            if (!block) {
+                std::shared_ptr<CBlock> block_read = std::make_shared<CBlock>();
+                if (!ReadBlockFromDisk(*block_read, pindex, consensus_params)) {
+                    FatalError("%s: Failed to read block %s from disk",
+                               __func__, pindex->GetBlockHash().ToString());
+                    return;
+                }
+                block = std::move(block_read);
             }
-            if (!WriteBlock(block, pindex)) {
+            if (!WriteBlock(*block, pindex)) {
                 FatalError("%s: Failed to write block %s to index database",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
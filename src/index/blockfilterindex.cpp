@@ -213,7 +213,8 @@ bool BlockFilterIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex
     uint256 prev_header;
 
     if (pindex->nHeight > 0) {
-        if (!UndoReadFromDisk(block_undo, pindex)) {
+        // The floData filter does not cover spent outputs.
+        if (m_filter_type != BlockFilterType::FLODATA && !UndoReadFromDisk(block_undo, pindex)) {
             return false;
         }
 
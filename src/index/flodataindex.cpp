@@ -0,0 +1,320 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/sha256.h>
+#include <index/flodataindex.h>
+#include <serialize.h>
+#include <util/system.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+
+constexpr uint8_t DB_FLODATA_PREFIX{'p'};
+constexpr uint8_t DB_FLODATA_HASH{'h'};
+constexpr uint8_t DB_BLOCK_STATS{'s'};
+
+//! Number of entries read before those of blocks no longer in the active chain are dropped.
+constexpr size_t FIND_BATCH_SIZE{1000};
+
+std::unique_ptr<FloDataIndex> g_flodataindex;
+
+void FloDataBlockStats::Add(const std::string& flo_data)
+{
+    if (flo_data.empty()) return;
+    ++count;
+    total_bytes += flo_data.size();
+    max_size = std::max<uint64_t>(max_size, flo_data.size());
+    const size_t separator = flo_data.find(':');
+    ++prefixes[separator < FLODATA_INDEX_PREFIX_SIZE ? flo_data.substr(0, separator + 1) : ""];
+}
+
+namespace {
+
+/**
+ * Key of an entry by floData prefix. The prefix is zero-padded to a fixed size
+ * so that keys sort by floData, and its unpadded length is stored after it.
+ */
+struct DBPrefixKey {
+    std::array<unsigned char, FLODATA_INDEX_PREFIX_SIZE> prefix{};
+    uint8_t prefix_len{0};
+    int height{0};
+    uint256 txid;
+
+    DBPrefixKey() = default;
+    DBPrefixKey(const std::string& flo_data, int height_in, const uint256& txid_in) : height(height_in), txid(txid_in)
+    {
+        prefix_len = std::min(flo_data.size(), FLODATA_INDEX_PREFIX_SIZE);
+        std::copy(flo_data.begin(), flo_data.begin() + prefix_len, prefix.begin());
+    }
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_FLODATA_PREFIX);
+        s.write((const char*)prefix.data(), prefix.size());
+        ser_writedata8(s, prefix_len);
+        ser_writedata32be(s, height);
+        s << txid;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t key_type{ser_readdata8(s)};
+        if (key_type != DB_FLODATA_PREFIX) {
+            throw std::ios_base::failure("Invalid format for flodataindex DB prefix key");
+        }
+        s.read((char*)prefix.data(), prefix.size());
+        prefix_len = ser_readdata8(s);
+        height = ser_readdata32be(s);
+        s >> txid;
+    }
+
+    bool StartsWith(const std::string& search) const
+    {
+        return search.size() <= prefix_len && std::equal(search.begin(), search.end(), prefix.begin());
+    }
+};
+
+/** Key to seek to the first entry whose floData may start with a prefix. */
+struct DBPrefixSeekKey {
+    const std::string& prefix;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_FLODATA_PREFIX);
+        s.write(prefix.data(), prefix.size());
+    }
+};
+
+/** Key of an entry by the SHA256 hash of its floData. */
+struct DBHashKey {
+    uint256 hash;
+    int height{0};
+    uint256 txid;
+
+    DBHashKey() = default;
+    DBHashKey(const uint256& hash_in, int height_in, const uint256& txid_in) : hash(hash_in), height(height_in), txid(txid_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_FLODATA_HASH);
+        s << hash;
+        ser_writedata32be(s, height);
+        s << txid;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t key_type{ser_readdata8(s)};
+        if (key_type != DB_FLODATA_HASH) {
+            throw std::ios_base::failure("Invalid format for flodataindex DB hash key");
+        }
+        s >> hash;
+        height = ser_readdata32be(s);
+        s >> txid;
+    }
+};
+
+/** Key of the FloDataBlockStats of the block at a height. */
+struct DBStatsKey {
+    int height;
+
+    explicit DBStatsKey(int height_in) : height(height_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_BLOCK_STATS);
+        ser_writedata32be(s, height);
+    }
+};
+
+uint256 FloDataHash(const std::string& flo_data)
+{
+    uint256 hash;
+    CSHA256().Write((const unsigned char*)flo_data.data(), flo_data.size()).Finalize(hash.begin());
+    return hash;
+}
+
+} // namespace
+
+/** Access to the flodataindex database (indexes/flodataindex/) */
+class FloDataIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the floData entries of a block to the DB.
+    bool WriteFloData(const CBlock& block, const CBlockIndex* pindex);
+
+    /// Read the entries whose floData starts with the given prefix, within a
+    /// height range, until visit returns false.
+    bool ReadByPrefix(const std::string& prefix, int start_height, int end_height,
+                      const std::function<bool(const FloDataIndexEntry&)>& visit);
+
+    /// Read the entries whose floData has the given SHA256 hash, within a
+    /// height range, until visit returns false.
+    bool ReadByHash(const uint256& flo_data_hash, int start_height, int end_height,
+                    const std::function<bool(const FloDataIndexEntry&)>& visit);
+
+    /// Read the statistics of a block, if it is the one last indexed at its height.
+    bool ReadBlockStats(const CBlockIndex* block_index, FloDataBlockStats& stats) const;
+};
+
+FloDataIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "flodataindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool FloDataIndex::DB::WriteFloData(const CBlock& block, const CBlockIndex* pindex)
+{
+    CDBBatch batch(*this);
+    const uint256 block_hash = pindex->GetBlockHash();
+    FloDataBlockStats stats;
+    for (const auto& tx : block.vtx) {
+        if (tx->strFloData.empty()) continue;
+        batch.Write(DBPrefixKey(tx->strFloData, pindex->nHeight, tx->GetHash()), block_hash);
+        batch.Write(DBHashKey(FloDataHash(tx->strFloData), pindex->nHeight, tx->GetHash()), block_hash);
+        stats.Add(tx->strFloData);
+    }
+    batch.Write(DBStatsKey(pindex->nHeight), std::make_pair(block_hash, stats));
+    return WriteBatch(batch);
+}
+
+bool FloDataIndex::DB::ReadByPrefix(const std::string& prefix, int start_height, int end_height,
+                                    const std::function<bool(const FloDataIndexEntry&)>& visit)
+{
+    std::unique_ptr<CDBIterator> iter(NewIterator());
+    iter->Seek(DBPrefixSeekKey{prefix});
+    while (iter->Valid()) {
+        DBPrefixKey key;
+        if (!iter->GetKey(key) || !std::equal(prefix.begin(), prefix.end(), key.prefix.begin())) break;
+        // Entries with the same stored prefix are ordered by height, so skip
+        // to the ones in the height range rather than reading the rest.
+        if (!key.StartsWith(prefix) || key.height > end_height) {
+            std::string next_prefix(key.prefix.begin(), key.prefix.end());
+            next_prefix.push_back(key.prefix_len + 1);
+            iter->Seek(DBPrefixSeekKey{next_prefix});
+            continue;
+        }
+        if (key.height < start_height) {
+            key.height = start_height;
+            key.txid.SetNull();
+            iter->Seek(key);
+            continue;
+        }
+        FloDataIndexEntry entry{key.txid, key.height, {}};
+        if (!iter->GetValue(entry.block_hash)) {
+            return error("%s: cannot read value for height %d", __func__, key.height);
+        }
+        if (!visit(entry)) break;
+        iter->Next();
+    }
+    return true;
+}
+
+bool FloDataIndex::DB::ReadByHash(const uint256& flo_data_hash, int start_height, int end_height,
+                                  const std::function<bool(const FloDataIndexEntry&)>& visit)
+{
+    std::unique_ptr<CDBIterator> iter(NewIterator());
+    for (iter->Seek(DBHashKey(flo_data_hash, start_height, uint256())); iter->Valid(); iter->Next()) {
+        DBHashKey key;
+        if (!iter->GetKey(key) || key.hash != flo_data_hash || key.height > end_height) break;
+        FloDataIndexEntry entry{key.txid, key.height, {}};
+        if (!iter->GetValue(entry.block_hash)) {
+            return error("%s: cannot read value for height %d", __func__, key.height);
+        }
+        if (!visit(entry)) break;
+    }
+    return true;
+}
+
+bool FloDataIndex::DB::ReadBlockStats(const CBlockIndex* block_index, FloDataBlockStats& stats) const
+{
+    std::pair<uint256, FloDataBlockStats> read_out;
+    if (!Read(DBStatsKey(block_index->nHeight), read_out) || read_out.first != block_index->GetBlockHash()) {
+        return false;
+    }
+    stats = std::move(read_out.second);
+    return true;
+}
+
+FloDataIndex::FloDataIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(std::make_unique<FloDataIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+FloDataIndex::~FloDataIndex() {}
+
+bool FloDataIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    return m_db->WriteFloData(block, pindex);
+}
+
+BaseIndex::DB& FloDataIndex::GetDB() const { return *m_db; }
+
+void FloDataIndex::AppendActive(std::vector<FloDataIndexEntry>& batch, size_t& count,
+                                std::vector<FloDataIndexEntry>& entries) const
+{
+    // Entries are not erased when blocks are disconnected, so skip the ones
+    // whose block was reorganized away.
+    if (m_chainstate) {
+        LOCK(cs_main);
+        const CChain& active_chain = m_chainstate->m_chain;
+        for (const FloDataIndexEntry& entry : batch) {
+            if (count == 0) break;
+            const CBlockIndex* pindex = active_chain[entry.height];
+            if (!pindex || pindex->GetBlockHash() != entry.block_hash) continue;
+            entries.push_back(entry);
+            --count;
+        }
+    }
+    batch.clear();
+}
+
+bool FloDataIndex::FindByPrefix(const std::string& prefix, int start_height, int end_height, size_t count,
+                                std::vector<FloDataIndexEntry>& entries) const
+{
+    if (prefix.size() > FLODATA_INDEX_PREFIX_SIZE) {
+        return error("%s: prefix longer than %u bytes", __func__, FLODATA_INDEX_PREFIX_SIZE);
+    }
+    std::vector<FloDataIndexEntry> batch;
+    const auto visit = [&](const FloDataIndexEntry& entry) {
+        batch.push_back(entry);
+        if (batch.size() < std::min(count, FIND_BATCH_SIZE)) return true;
+        AppendActive(batch, count, entries);
+        return count > 0;
+    };
+    if (!m_db->ReadByPrefix(prefix, start_height, end_height, visit)) {
+        return false;
+    }
+    AppendActive(batch, count, entries);
+    return true;
+}
+
+bool FloDataIndex::FindByHash(const uint256& flo_data_hash, int start_height, int end_height, size_t count,
+                              std::vector<FloDataIndexEntry>& entries) const
+{
+    std::vector<FloDataIndexEntry> batch;
+    const auto visit = [&](const FloDataIndexEntry& entry) {
+        batch.push_back(entry);
+        if (batch.size() < std::min(count, FIND_BATCH_SIZE)) return true;
+        AppendActive(batch, count, entries);
+        return count > 0;
+    };
+    if (!m_db->ReadByHash(flo_data_hash, start_height, end_height, visit)) {
+        return false;
+    }
+    AppendActive(batch, count, entries);
+    return true;
+}
+
+bool FloDataIndex::LookUpBlockStats(const CBlockIndex* block_index, FloDataBlockStats& stats) const
+{
+    return m_db->ReadBlockStats(block_index, stats);
+}
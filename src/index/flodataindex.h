@@ -0,0 +1,99 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_INDEX_FLODATAINDEX_H
+#define FLOCOIN_INDEX_FLODATAINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <serialize.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/** Number of leading floData bytes that can be searched by prefix. */
+static constexpr size_t FLODATA_INDEX_PREFIX_SIZE{32};
+
+/** A transaction carrying floData, as found in the index. */
+struct FloDataIndexEntry {
+    uint256 txid;
+    int height;
+    uint256 block_hash;
+};
+
+/** floData statistics of a block, as reported by getblockstats. */
+struct FloDataBlockStats {
+    uint64_t count{0};
+    uint64_t total_bytes{0};
+    uint64_t max_size{0};
+    //! Number of floData per application prefix: the floData up to its first
+    //! ':' within FLODATA_INDEX_PREFIX_SIZE bytes, or "" if there is none.
+    std::map<std::string, uint64_t> prefixes;
+
+    /** Account for the floData of a transaction. Empty floData is ignored. */
+    void Add(const std::string& flo_data);
+
+    SERIALIZE_METHODS(FloDataBlockStats, obj)
+    {
+        READWRITE(VARINT(obj.count), VARINT(obj.total_bytes), VARINT(obj.max_size), obj.prefixes);
+    }
+};
+
+/**
+ * FloDataIndex is used to find the transactions in the active chain which carry
+ * floData, by floData prefix or by the SHA256 hash of the floData. Transactions
+ * without floData are not indexed. It also keeps the FloDataBlockStats of
+ * every block.
+ */
+class FloDataIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    /// Move the entries of batch whose block is in the active chain to entries,
+    /// at most count of them, and reduce count by their number.
+    void AppendActive(std::vector<FloDataIndexEntry>& batch, size_t& count,
+                      std::vector<FloDataIndexEntry>& entries) const;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "flodataindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit FloDataIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~FloDataIndex() override;
+
+    /// Look up the transactions whose floData starts with the given prefix, in
+    /// blocks of the active chain from start_height to end_height inclusive,
+    /// and append the first count of them to entries.
+    /// The prefix must not be longer than FLODATA_INDEX_PREFIX_SIZE bytes.
+    /// Entries are ordered by floData, then by height.
+    bool FindByPrefix(const std::string& prefix, int start_height, int end_height, size_t count,
+                      std::vector<FloDataIndexEntry>& entries) const;
+
+    /// Look up the transactions whose floData has the given SHA256 hash, in
+    /// blocks of the active chain from start_height to end_height inclusive,
+    /// and append the first count of them to entries, ordered by height.
+    bool FindByHash(const uint256& flo_data_hash, int start_height, int end_height, size_t count,
+                    std::vector<FloDataIndexEntry>& entries) const;
+
+    /// Look up the floData statistics of a block of the active chain.
+    /// Returns false if the block has not been indexed.
+    bool LookUpBlockStats(const CBlockIndex* block_index, FloDataBlockStats& stats) const;
+};
+
+/// The global floData index, used in the searchflodata RPC. May be null.
+extern std::unique_ptr<FloDataIndex> g_flodataindex;
+
+#endif // FLOCOIN_INDEX_FLODATAINDEX_H
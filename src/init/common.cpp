@@ -8,6 +8,7 @@
 
 #include <clientversion.h>
 #include <compat/sanity.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha256.h>
 #include <key.h>
 #include <logging.h>
@@ -27,6 +28,8 @@ void SetGlobals()
 {
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string scrypt_algo = ScryptAutoDetect();
+    LogPrintf("Using the '%s' scrypt implementation\n", scrypt_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -62,6 +62,18 @@ public:
     CBlock* m_data = nullptr;
 };
 
+//! Interface for reading the blocks of the active chain in height order,
+//! while the blocks after the last one requested are read in the background.
+class BlockReader
+{
+public:
+    virtual ~BlockReader() {}
+
+    //! Read a block. Returns false if the block is unknown, and sets the block
+    //! to null if its data could not be read, like findBlock() does.
+    virtual bool readBlock(const uint256& hash, CBlock& block) = 0;
+};
+
 //! Interface giving clients (wallet processes, maybe other analysis tools in
 //! the future) ability to access to the chain state, receive notifications,
 //! estimate fees, and submit transactions.
@@ -118,6 +130,10 @@ public:
     //! or contents.
     virtual bool findBlock(const uint256& hash, const FoundBlock& block={}) = 0;
 
+    //! Return a BlockReader that reads up to -blockprefetch blocks ahead of the
+    //! one last requested, for scans over the active chain.
+    virtual std::unique_ptr<BlockReader> makeBlockReader() = 0;
+
     //! Find first block in the chain with timestamp >= the given time
     //! and height >= than the given height, return false if there is no block
     //! with a high enough timestamp and height. Optionally return block
@@ -7,6 +7,7 @@
 
 #include <indirectmap.h>
 #include <prevector.h>
+#include <support/allocators/pool.h>
 
 #include <stdlib.h>
 
@@ -14,6 +15,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -89,6 +91,14 @@ static inline size_t DynamicUsage(const std::vector<X>& v)
     return MallocUsage(v.capacity() * sizeof(X));
 }
 
+static inline size_t DynamicUsage(const std::string& s)
+{
+    // Short strings are stored inside the object itself and use no heap memory.
+    const uintptr_t data = reinterpret_cast<uintptr_t>(s.data());
+    if (data >= reinterpret_cast<uintptr_t>(&s) && data < reinterpret_cast<uintptr_t>(&s + 1)) return 0;
+    return MallocUsage(s.capacity() + 1);
+}
+
 template<unsigned int N, typename X, typename S, typename D>
 static inline size_t DynamicUsage(const prevector<N, X, S, D>& v)
 {
@@ -167,6 +177,18 @@ static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z>& m)
     return MallocUsage(sizeof(unordered_node<std::pair<const X, Y> >)) * m.size() + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+template <class Key, class T, class Hash, class Pred, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+static inline size_t DynamicUsage(const std::unordered_map<Key, T, Hash, Pred, PoolAllocator<std::pair<const Key, T>, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>>& m)
+{
+    // The nodes live in the chunks of the pool, whether in use or free. The
+    // bucket array is too large for the pool and is malloc'ed directly.
+    const auto* pool_resource = m.get_allocator().resource();
+    const size_t num_chunks = pool_resource->NumAllocatedChunks();
+    return MallocUsage(pool_resource->ChunkSizeBytes()) * num_chunks +
+           MallocUsage(sizeof(void*) * num_chunks) +
+           MallocUsage(sizeof(void*) * m.bucket_count());
+}
+
 }
 
 #endif // FLOCOIN_MEMUSAGE_H
@@ -7,6 +7,7 @@
 #include <miner.h>
 
 #include <amount.h>
+#include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <coins.h>
@@ -19,11 +20,17 @@
 #include <policy/policy.h>
 #include <pow.h>
 #include <primitives/transaction.h>
+#include <shutdown.h>
 #include <timedata.h>
 #include <util/moneystr.h>
 #include <util/system.h>
+#include <util/threadnames.h>
+#include <util/time.h>
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 #include <utility>
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
@@ -455,3 +462,93 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
+
+/** Most nonces hashed at once by a SearchNonce() thread, matching the widest multi-buffer scrypt kernel. */
+static constexpr uint64_t NONCE_BATCH_SIZE = 16;
+
+static std::atomic<uint64_t> g_search_nonce_hashes{0};
+static std::atomic<int64_t> g_search_nonce_micros{0};
+
+/** Number of hashes expected to find a nonce meeting nBits, saturating at max. */
+static uint64_t ExpectedHashes(uint32_t nBits, uint64_t max)
+{
+    bool negative, overflow;
+    arith_uint256 target;
+    target.SetCompact(nBits, &negative, &overflow);
+    if (negative || overflow || target == 0) return max;
+    const arith_uint256 expected = (~target / (target + 1)) + 1;
+    return expected >= arith_uint256{max} ? max : expected.GetLow64();
+}
+
+bool SearchNonce(CBlockHeader& header, const Consensus::Params& params, int threads, uint64_t& max_tries)
+{
+    const uint64_t start = header.nNonce;
+    const uint64_t end = start + std::min<uint64_t>(max_tries, std::numeric_limits<uint32_t>::max() - start);
+
+    // Hashes past the valid nonce are wasted, so only use as many threads and
+    // as wide batches as about half the expected work fills. Easy targets, such
+    // as regtest's, are then searched one nonce at a time on this thread.
+    threads = std::max(threads, 1);
+    const uint64_t work = std::max<uint64_t>(ExpectedHashes(header.nBits, 2 * threads * NONCE_BATCH_SIZE) / 2, 1);
+    const int threads_used = std::clamp<uint64_t>(work / NONCE_BATCH_SIZE, 1, threads);
+    const uint64_t batch_size = std::clamp<uint64_t>(work / threads_used, 1, NONCE_BATCH_SIZE);
+    const uint64_t batches = (end - start + batch_size - 1) / batch_size;
+
+    std::atomic<uint64_t> next_batch{0};
+    std::atomic<uint64_t> found{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> hashes{0};
+
+    auto search = [&] {
+        while (!ShutdownRequested()) {
+            const uint64_t batch = next_batch++;
+            const uint64_t first = start + batch * batch_size;
+            // Batches are claimed in nonce order, so no later batch can hold a lower valid nonce.
+            if (batch >= batches || first >= found) break;
+
+            std::vector<CBlockHeader> candidates(std::min(batch_size, end - first), header);
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                candidates[i].nNonce = first + i;
+            }
+            const std::vector<uint256> pow_hashes = GetPoWHashes(candidates);
+            hashes += candidates.size();
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                if (!CheckProofOfWork(pow_hashes[i], header.nBits, params)) continue;
+                uint64_t lowest = found;
+                while (first + i < lowest && !found.compare_exchange_weak(lowest, first + i)) {}
+                break;
+            }
+        }
+    };
+
+    const int64_t time_start = GetTimeMicros();
+    std::vector<std::thread> workers;
+    for (int n = 1; n < threads_used && (uint64_t)n < batches; ++n) {
+        workers.emplace_back([&, n] {
+            util::ThreadRename(strprintf("miner.%i", n));
+            search();
+        });
+    }
+    search();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    g_search_nonce_hashes += hashes;
+    g_search_nonce_micros += GetTimeMicros() - time_start;
+
+    if (found != std::numeric_limits<uint64_t>::max()) {
+        header.nNonce = found;
+        max_tries -= found - start;
+        return true;
+    }
+    header.nNonce = end;
+    max_tries -= end - start;
+    return false;
+}
+
+std::optional<double> GetSearchNonceHashRate()
+{
+    const uint64_t hashes = g_search_nonce_hashes;
+    const int64_t micros = g_search_nonce_micros;
+    if (hashes == 0) return std::nullopt;
+    return micros > 0 ? hashes * 1e6 / micros : 0.0;
+}
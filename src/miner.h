@@ -25,6 +25,8 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+/** -minerthreads default (number of threads searching for a nonce in the generate RPCs, 0 = one per core) */
+static const int DEFAULT_MINER_THREADS = 1;
 
 struct CBlockTemplate
 {
@@ -206,4 +208,21 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 /** Update an old GenerateCoinbaseCommitment from CreateNewBlock after the block txs have changed */
 void RegenerateCommitments(CBlock& block, ChainstateManager& chainman);
 
+/**
+ * Search for a nonce giving the header a valid proof of work, starting at its
+ * current nNonce. The nonce space is split across up to `threads` threads,
+ * each hashing batches of nonces with the multi-buffer scrypt kernels. Fewer
+ * threads and narrower batches are used for targets met within a few hashes.
+ *
+ * At most max_tries nonces are tried, and the maximum nonce never is. If a
+ * valid nonce is found, the lowest one is set in the header and true is
+ * returned. Otherwise nNonce is set to the first untried nonce. In both cases
+ * max_tries is reduced by the number of nonces tried before it, as a
+ * single-threaded search would have.
+ */
+bool SearchNonce(CBlockHeader& header, const Consensus::Params& params, int threads, uint64_t& max_tries);
+
+/** Average hashes per second of all SearchNonce() calls so far, or nullopt if there were none. */
+std::optional<double> GetSearchNonceHashRate();
+
 #endif // FLOCOIN_MINER_H
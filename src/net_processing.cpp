@@ -2270,8 +2270,9 @@ bool PeerManagerImpl::PrepareBlockFilterRequest(CNode& peer,
                                                 BlockFilterIndex*& filter_index)
 {
     const bool supported_filter_type =
-        (filter_type == BlockFilterType::BASIC &&
-         (peer.GetLocalServices() & NODE_COMPACT_FILTERS));
+        (filter_type == BlockFilterType::BASIC ||
+         (filter_type == BlockFilterType::FLODATA && GetBlockFilterIndex(filter_type))) &&
+        (peer.GetLocalServices() & NODE_COMPACT_FILTERS);
     if (!supported_filter_type) {
         LogPrint(BCLog::NET, "peer %d requested unsupported block filter type: %d\n",
                  peer.GetId(), static_cast<uint8_t>(filter_type));
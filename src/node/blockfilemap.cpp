@@ -0,0 +1,83 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockfilemap.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<const MappedFile> MappedFile::Map(const fs::path& path, size_t size)
+{
+#ifndef WIN32
+    if (size == 0) return nullptr;
+    const int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd == -1) return nullptr;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after the file is closed.
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    return std::unique_ptr<const MappedFile>(new MappedFile((const unsigned char*)data, size));
+#else
+    return nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef WIN32
+    munmap((void*)m_data, m_size);
+#endif
+}
+
+std::shared_ptr<const MappedFile> MappedFileCache::Get(int file, const fs::path& path, size_t min_size, size_t size)
+{
+    LOCK(m_mutex);
+    if (m_max_mappings == 0) return nullptr;
+    auto it = m_by_file.find(file);
+    if (it != m_by_file.end()) {
+        if (it->second->second->data().size() >= min_size) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->second;
+        }
+        // The file has grown since it was mapped.
+        m_lru.erase(it->second);
+        m_by_file.erase(it);
+    }
+    if (size < min_size) return nullptr;
+
+    std::shared_ptr<const MappedFile> mapping = MappedFile::Map(path, size);
+    if (!mapping) return nullptr;
+    m_lru.emplace_front(file, mapping);
+    m_by_file.emplace(file, m_lru.begin());
+    Trim();
+    return mapping;
+}
+
+void MappedFileCache::Erase(int file)
+{
+    LOCK(m_mutex);
+    auto it = m_by_file.find(file);
+    if (it == m_by_file.end()) return;
+    m_lru.erase(it->second);
+    m_by_file.erase(it);
+}
+
+void MappedFileCache::SetMaxMappings(size_t max_mappings)
+{
+    LOCK(m_mutex);
+    m_max_mappings = max_mappings;
+    Trim();
+}
+
+void MappedFileCache::Trim()
+{
+    // Mappings still in use by readers are unmapped once they are done.
+    while (m_lru.size() > m_max_mappings) {
+        m_by_file.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_NODE_BLOCKFILEMAP_H
+#define FLOCOIN_NODE_BLOCKFILEMAP_H
+
+#include <fs.h>
+#include <span.h>
+#include <sync.h>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+/** A read-only memory mapping of the start of a file. */
+class MappedFile
+{
+public:
+    /** Map the first size bytes of a file. Returns nullptr if it cannot be mapped. */
+    static std::unique_ptr<const MappedFile> Map(const fs::path& path, size_t size);
+
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    Span<const unsigned char> data() const { return {m_data, m_size}; }
+
+private:
+    MappedFile(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+    const unsigned char* const m_data;
+    const size_t m_size;
+};
+
+/**
+ * Least recently used cache of the mappings of the files of a flat file
+ * sequence (e.g. blk?????.dat), by file number. Only the start of a file that
+ * no longer changes may be mapped, as a mapped file must not shrink.
+ */
+class MappedFileCache
+{
+public:
+    explicit MappedFileCache(size_t max_mappings) : m_max_mappings(max_mappings) {}
+
+    /**
+     * Return a mapping of at least the first min_size bytes of a file, mapping
+     * its first size bytes if no such mapping is cached. Returns nullptr if
+     * the file cannot be mapped or caching is disabled.
+     */
+    std::shared_ptr<const MappedFile> Get(int file, const fs::path& path, size_t min_size, size_t size);
+
+    /** Drop the mapping of a file, e.g. once it is deleted. */
+    void Erase(int file);
+
+    /** Set the maximum number of mappings kept. 0 disables mapping. */
+    void SetMaxMappings(size_t max_mappings);
+
+private:
+    using LruList = std::list<std::pair<int, std::shared_ptr<const MappedFile>>>;
+
+    void Trim() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    Mutex m_mutex;
+    size_t m_max_mappings GUARDED_BY(m_mutex);
+    //! Most recently used first
+    LruList m_lru GUARDED_BY(m_mutex);
+    std::map<int, LruList::iterator> m_by_file GUARDED_BY(m_mutex);
+};
+
+#endif // FLOCOIN_NODE_BLOCKFILEMAP_H
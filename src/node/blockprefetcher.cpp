@@ -0,0 +1,127 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockprefetcher.h>
+
+#include <chain.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <tinyformat.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+#include <set>
+
+int g_block_prefetch = DEFAULT_BLOCK_PREFETCH;
+
+BlockPrefetcher::BlockPrefetcher(const Consensus::Params& consensus_params, int threads, Prepare prepare)
+    : m_consensus_params(consensus_params), m_prepare(std::move(prepare))
+{
+    for (int n = 0; n < threads; ++n) {
+        m_worker_threads.emplace_back([this, n]() {
+            util::ThreadRename(strprintf("prefetch.%i", n));
+            ThreadPrefetch();
+        });
+    }
+}
+
+BlockPrefetcher::~BlockPrefetcher()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cond.notify_all();
+    for (std::thread& t : m_worker_threads) {
+        t.join();
+    }
+}
+
+void BlockPrefetcher::Prefetch(const std::vector<BlockRef>& blocks)
+{
+    {
+        LOCK(m_mutex);
+        std::set<uint256> wanted;
+        for (const auto& [hash, pos] : blocks) {
+            wanted.insert(hash);
+        }
+        // Drop blocks that are no longer wanted, except those being read,
+        // which their worker drops once done.
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (!wanted.count(it->first) && it->second.state != Entry::READING) {
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_queue.clear();
+        for (const auto& [hash, pos] : blocks) {
+            auto [it, inserted] = m_entries.try_emplace(hash);
+            if (inserted) it->second.pos = pos;
+            if (it->second.state == Entry::QUEUED) m_queue.push_back(hash);
+        }
+    }
+    m_cond.notify_all();
+}
+
+void BlockPrefetcher::Prefetch(const CChain& chain, const CBlockIndex* pindex, int count)
+{
+    AssertLockHeld(::cs_main);
+    std::vector<BlockRef> blocks;
+    if (pindex && chain.Contains(pindex)) {
+        for (int height = pindex->nHeight; height < pindex->nHeight + count && height <= chain.Height(); ++height) {
+            const CBlockIndex* block_index = chain[height];
+            if (!(block_index->nStatus & BLOCK_HAVE_DATA)) break;
+            blocks.emplace_back(block_index->GetBlockHash(), block_index->GetBlockPos());
+        }
+    }
+    Prefetch(blocks);
+}
+
+std::shared_ptr<const CBlock> BlockPrefetcher::Get(const uint256& hash)
+{
+    WAIT_LOCK(m_mutex, lock);
+    auto it = m_entries.find(hash);
+    m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        it = m_entries.find(hash);
+        return it == m_entries.end() || it->second.state != Entry::READING;
+    });
+    if (it == m_entries.end()) return nullptr;
+    if (it->second.state == Entry::QUEUED) {
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), hash), m_queue.end());
+        m_entries.erase(it);
+        return nullptr;
+    }
+    std::shared_ptr<const CBlock> block = std::move(it->second.block);
+    m_entries.erase(it);
+    return block;
+}
+
+void BlockPrefetcher::ThreadPrefetch()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (true) {
+        m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queue.empty(); });
+        if (m_stop) return;
+
+        const uint256 hash = m_queue.front();
+        m_queue.pop_front();
+        Entry& entry = m_entries.at(hash);
+        entry.state = Entry::READING;
+        const FlatFilePos pos = entry.pos;
+
+        std::shared_ptr<CBlock> block = std::make_shared<CBlock>();
+        {
+            REVERSE_LOCK(lock);
+            if (!ReadBlockFromDisk(*block, pos, m_consensus_params, fCheckBlockReads) || block->GetHash() != hash) {
+                block.reset();
+            } else if (m_prepare) {
+                m_prepare(*block);
+            }
+        }
+
+        // Prefetch() keeps entries being read, even if they are no longer wanted.
+        auto it = m_entries.find(hash);
+        it->second.state = Entry::DONE;
+        it->second.block = std::move(block);
+        m_cond.notify_all();
+    }
+}
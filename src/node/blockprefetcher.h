@@ -0,0 +1,95 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_NODE_BLOCKPREFETCHER_H
+#define FLOCOIN_NODE_BLOCKPREFETCHER_H
+
+#include <flatfile.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CChain;
+namespace Consensus {
+struct Params;
+}
+
+extern RecursiveMutex cs_main;
+
+/** -blockprefetch default: number of blocks read ahead of block scans */
+static const int DEFAULT_BLOCK_PREFETCH = 16;
+/** Maximum -blockprefetch, which bounds the memory held by prefetched blocks */
+static const int MAX_BLOCK_PREFETCH = 1024;
+/** Number of threads reading blocks ahead of a reindex, rescan or index sync */
+static const int BLOCK_PREFETCH_THREADS = 2;
+
+/** Number of blocks to read ahead of scans over the block files (0 = disabled). */
+extern int g_block_prefetch;
+
+/**
+ * Reads blocks from disk on background threads ahead of the thread that
+ * consumes them, so that reading, deserializing and any context-free checks
+ * of the next blocks overlap with the processing of the current one.
+ *
+ * The consumer announces the blocks it will want next with Prefetch() and
+ * collects each with Get(). Blocks that are not prefetched (yet) are simply
+ * reported as missing, and the consumer reads them itself.
+ */
+class BlockPrefetcher
+{
+public:
+    using BlockRef = std::pair<uint256, FlatFilePos>;
+    //! Run on a worker thread on every block read, e.g. to cache CheckBlock().
+    using Prepare = std::function<void(const CBlock&)>;
+
+    BlockPrefetcher(const Consensus::Params& consensus_params, int threads, Prepare prepare = {});
+    ~BlockPrefetcher();
+
+    /**
+     * Set the blocks to prefetch, in the order they will be consumed. Blocks
+     * of an earlier call that are not in the list are dropped.
+     */
+    void Prefetch(const std::vector<BlockRef>& blocks);
+
+    /** Prefetch up to count blocks of a chain, starting at pindex. */
+    void Prefetch(const CChain& chain, const CBlockIndex* pindex, int count) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * Take a prefetched block, waiting for it if it is being read. Returns
+     * nullptr if the block was not requested, not read yet, or could not be read.
+     */
+    std::shared_ptr<const CBlock> Get(const uint256& hash);
+
+private:
+    struct Entry {
+        FlatFilePos pos;
+        enum { QUEUED, READING, DONE } state{QUEUED};
+        std::shared_ptr<const CBlock> block;
+    };
+
+    void ThreadPrefetch();
+
+    const Consensus::Params& m_consensus_params;
+    const Prepare m_prepare;
+
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    std::map<uint256, Entry> m_entries GUARDED_BY(m_mutex);
+    std::deque<uint256> m_queue GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    std::vector<std::thread> m_worker_threads;
+};
+
+#endif // FLOCOIN_NODE_BLOCKPREFETCHER_H
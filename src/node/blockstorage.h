@@ -27,6 +27,9 @@ struct Params;
 }
 
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
+static constexpr bool DEFAULT_CHECKBLOCKREADS{false};
+/** -blockfilemaps default: block and undo files kept memory mapped for reads (off, as I/O errors on mapped files raise SIGBUS) */
+static constexpr unsigned int DEFAULT_BLOCKFILEMAPS{0};
 
 /** The pre-allocation chunk size for blk?????.dat files (since 0.8) */
 static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
@@ -44,6 +47,8 @@ extern bool fHavePruned;
 extern bool fPruneMode;
 /** Number of MiB of block files that we're trying to stay below. */
 extern uint64_t nPruneTarget;
+/** Whether to recheck the scrypt proof of work of indexed blocks read from disk (-checkblockreads). */
+extern bool fCheckBlockReads;
 
 //! Check whether the block associated with this index entry is pruned or not.
 bool IsBlockPruned(const CBlockIndex* pblockindex);
@@ -58,6 +63,9 @@ fs::path GetBlockPosFilename(const FlatFilePos& pos);
 /** Get block file info entry for one block file */
 CBlockFileInfo* GetBlockFileInfo(size_t n);
 
+/** Set the number of block and undo files each kept memory mapped for reads (-blockfilemaps) */
+void SetBlockFileMapLimit(size_t max_mappings);
+
 /** Calculate the amount of disk space the block & undo files currently use */
 uint64_t CalculateCurrentUsage();
 
@@ -67,7 +75,7 @@ uint64_t CalculateCurrentUsage();
 void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune);
 
 /** Functions for disk access for blocks */
-bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams);
+bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams, bool fCheckPOW = true);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
@@ -79,4 +87,12 @@ FlatFilePos SaveBlockToDisk(const CBlock& block, int nHeight, CChain& active_cha
 
 void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImportFiles, const ArgsManager& args);
 
+/**
+ * Compute and store the scrypt proof-of-work hash of every block index entry
+ * that does not have one yet (e.g. entries written by older versions), so that
+ * it does not need to be recomputed on later startups. Runs in batches without
+ * holding cs_main during the scrypt computations, and stops on shutdown.
+ */
+void FillBlockIndexPoWHashes(ChainstateManager& chainman, const Consensus::Params& consensusParams);
+
 #endif // FLOCOIN_NODE_BLOCKSTORAGE_H
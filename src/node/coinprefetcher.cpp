@@ -0,0 +1,171 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/coinprefetcher.h>
+
+#include <node/blockprefetcher.h>
+#include <primitives/block.h>
+#include <tinyformat.h>
+#include <txdb.h>
+#include <util/hasher.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+//! Number of coins a thread claims at a time when reading in parallel.
+static constexpr size_t COIN_READ_CHUNK_SIZE = 16;
+
+/** The outpoints a block spends, except those created by the block itself. */
+static std::vector<COutPoint> GetBlockPrevouts(const CBlock& block)
+{
+    std::unordered_set<uint256, SaltedTxidHasher> txids;
+    std::vector<COutPoint> prevouts;
+    for (const auto& tx : block.vtx) {
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                if (!txids.count(txin.prevout.hash)) prevouts.push_back(txin.prevout);
+            }
+        }
+        txids.insert(tx->GetHash());
+    }
+    return prevouts;
+}
+
+/** Read a coin. Errors are left to the regular lookup to report. */
+static bool ReadCoin(const CCoinsViewDB& db, const COutPoint& outpoint, Coin& coin)
+{
+    try {
+        return db.GetCoin(outpoint, coin);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+CoinPrefetcher::CoinPrefetcher(const CCoinsViewDB& db, int threads) : m_db(db)
+{
+    for (int n = 0; n < threads; ++n) {
+        m_worker_threads.emplace_back([this, n]() {
+            util::ThreadRename(strprintf("coinfetch.%i", n));
+            ThreadRead();
+        });
+    }
+}
+
+CoinPrefetcher::~CoinPrefetcher()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cond.notify_all();
+    for (std::thread& t : m_worker_threads) {
+        t.join();
+    }
+}
+
+void CoinPrefetcher::PrefetchBlock(const CBlock& block)
+{
+    // Coins read while the database is written may be outdated either way.
+    const uint64_t write_sequence = m_db.GetWriteSequence();
+    if (write_sequence % 2) return;
+
+    Prefetched prefetched{block.GetHash(), write_sequence, {}};
+    for (const COutPoint& outpoint : GetBlockPrevouts(block)) {
+        Coin coin;
+        if (ReadCoin(m_db, outpoint, coin)) prefetched.coins.emplace_back(outpoint, std::move(coin));
+    }
+
+    LOCK(m_mutex);
+    m_prefetched.push_back(std::move(prefetched));
+    // Drop coins of blocks that were never connected.
+    while (m_prefetched.size() > MAX_BLOCK_PREFETCH) {
+        m_prefetched.pop_front();
+    }
+}
+
+void CoinPrefetcher::WarmCache(const CBlock& block, CCoinsViewCache& cache)
+{
+    AssertLockHeld(::cs_main);
+    const uint256 block_hash = block.GetHash();
+    Coins coins;
+    {
+        LOCK(m_mutex);
+        auto it = std::find_if(m_prefetched.begin(), m_prefetched.end(), [&](const Prefetched& p) { return p.block_hash == block_hash; });
+        if (it != m_prefetched.end()) {
+            // A write since the coins were read may have changed them, so
+            // they are only as good as the cache, which the write emptied.
+            if (it->write_sequence == m_db.GetWriteSequence()) coins = std::move(it->coins);
+            m_prefetched.erase(it);
+        }
+    }
+    // Coins the cache has an entry for are not replaced, as the cache's
+    // version is the current one.
+    for (auto& [outpoint, coin] : coins) {
+        cache.AddCoinFromBase(outpoint, std::move(coin));
+    }
+
+    std::vector<COutPoint> outpoints;
+    for (const COutPoint& outpoint : GetBlockPrevouts(block)) {
+        if (!cache.HaveCoinInCache(outpoint)) outpoints.push_back(outpoint);
+    }
+    if (m_worker_threads.empty() || outpoints.size() <= COIN_READ_CHUNK_SIZE) return;
+
+    // With cs_main held the database is not written while the coins are read.
+    {
+        LOCK(m_mutex);
+        m_job = &outpoints;
+        ++m_job_id;
+        m_job_workers = m_worker_threads.size();
+        m_job_next = 0;
+    }
+    m_cond.notify_all();
+
+    coins.clear();
+    ReadJob(outpoints, coins);
+
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_job_workers == 0; });
+        m_job = nullptr;
+        coins.insert(coins.end(), std::make_move_iterator(m_job_coins.begin()), std::make_move_iterator(m_job_coins.end()));
+        m_job_coins.clear();
+    }
+    for (auto& [outpoint, coin] : coins) {
+        cache.AddCoinFromBase(outpoint, std::move(coin));
+    }
+}
+
+void CoinPrefetcher::ReadJob(const std::vector<COutPoint>& outpoints, Coins& coins)
+{
+    while (true) {
+        const size_t begin = m_job_next.fetch_add(COIN_READ_CHUNK_SIZE);
+        if (begin >= outpoints.size()) return;
+        const size_t end = std::min(begin + COIN_READ_CHUNK_SIZE, outpoints.size());
+        for (size_t i = begin; i < end; ++i) {
+            Coin coin;
+            if (ReadCoin(m_db, outpoints[i], coin)) coins.emplace_back(outpoints[i], std::move(coin));
+        }
+    }
+}
+
+void CoinPrefetcher::ThreadRead()
+{
+    WAIT_LOCK(m_mutex, lock);
+    uint64_t last_job_id = m_job_id;
+    while (true) {
+        m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || m_job_id != last_job_id; });
+        if (m_stop) return;
+        last_job_id = m_job_id;
+
+        // WarmCache() keeps the job alive until every worker is done with it.
+        const std::vector<COutPoint>& outpoints = *m_job;
+        Coins coins;
+        {
+            REVERSE_LOCK(lock);
+            ReadJob(outpoints, coins);
+        }
+        m_job_coins.insert(m_job_coins.end(), std::make_move_iterator(coins.begin()), std::make_move_iterator(coins.end()));
+        if (--m_job_workers == 0) m_cond.notify_all();
+    }
+}
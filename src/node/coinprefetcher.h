@@ -0,0 +1,87 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_NODE_COINPREFETCHER_H
+#define FLOCOIN_NODE_COINPREFETCHER_H
+
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CCoinsViewDB;
+
+extern RecursiveMutex cs_main;
+
+/**
+ * Reads the coins spent by a block from the coins database before the block
+ * is connected, so that connecting it doesn't have to look them up one at a
+ * time.
+ *
+ * The coins of the block about to be connected are read by several threads
+ * in parallel. Blocks further ahead can be handed to PrefetchBlock() as soon
+ * as they are read from disk (see BlockPrefetcher), whose coins are then read
+ * while the blocks before them are being connected.
+ */
+class CoinPrefetcher
+{
+public:
+    CoinPrefetcher(const CCoinsViewDB& db, int threads);
+    ~CoinPrefetcher();
+
+    /**
+     * Read the coins a block spends and keep them until WarmCache() is called
+     * for the block. Can be called from any thread, without cs_main, as long
+     * as the database is not resized meanwhile (see CCoinsViewDB::ResizeCache()).
+     */
+    void PrefetchBlock(const CBlock& block);
+
+    /**
+     * Add the coins a block spends to the cache, which must be the cache on
+     * top of the database. Coins read by PrefetchBlock() are used if the
+     * database hasn't been written since; the rest are read in parallel.
+     */
+    void WarmCache(const CBlock& block, CCoinsViewCache& cache) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+private:
+    using Coins = std::vector<std::pair<COutPoint, Coin>>;
+
+    struct Prefetched {
+        uint256 block_hash;
+        //! CCoinsViewDB::GetWriteSequence() when the coins were read.
+        uint64_t write_sequence;
+        Coins coins;
+    };
+
+    /** Read coins of the current job until none are left. */
+    void ReadJob(const std::vector<COutPoint>& outpoints, Coins& coins);
+    void ThreadRead();
+
+    const CCoinsViewDB& m_db;
+
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Prefetched> m_prefetched GUARDED_BY(m_mutex);
+
+    //! Outpoints being read in parallel by WarmCache(), and the coins found.
+    const std::vector<COutPoint>* m_job GUARDED_BY(m_mutex){nullptr};
+    uint64_t m_job_id GUARDED_BY(m_mutex){0};
+    int m_job_workers GUARDED_BY(m_mutex){0};
+    Coins m_job_coins GUARDED_BY(m_mutex);
+    std::atomic<size_t> m_job_next{0};
+
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_worker_threads;
+};
+
+#endif // FLOCOIN_NODE_COINPREFETCHER_H
@@ -0,0 +1,178 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/flodataexport.h>
+
+#include <chain.h>
+#include <clientversion.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <univalue.h>
+#include <util/system.h>
+#include <util/threadnames.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <thread>
+
+namespace {
+
+/** The blocks to export from one block file, in file order. */
+struct BlockFileJob {
+    std::vector<FloDataExportBlock> blocks;
+    std::vector<unsigned char> output;
+    FloDataExportStats stats;
+    enum { PENDING, DONE, FAILED } state{PENDING};
+};
+
+bool ExportBlockFile(BlockFileJob& job, FloDataExportFormat format, const std::atomic<bool>& abort)
+{
+    const FlatFilePos& first_pos = job.blocks.front().pos;
+    FILE* file;
+    {
+        // Pruning marks blocks as not stored under cs_main before it deletes
+        // their file, and an open file stays readable once it is deleted.
+        LOCK(cs_main);
+        for (const FloDataExportBlock& entry : job.blocks) {
+            if (!(entry.index->nStatus & BLOCK_HAVE_DATA)) {
+                return error("%s: block %s was pruned", __func__, entry.index->GetBlockHash().ToString());
+            }
+        }
+        file = OpenBlockFile(first_pos, true);
+    }
+    CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull()) {
+        return error("%s: OpenBlockFile failed for %s", __func__, first_pos.ToString());
+    }
+
+    CBlock block;
+    for (const FloDataExportBlock& entry : job.blocks) {
+        if (abort) return false;
+        if (fseek(filein.Get(), entry.pos.nPos, SEEK_SET)) {
+            return error("%s: fseek failed for %s", __func__, entry.pos.ToString());
+        }
+        try {
+            filein >> block;
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), entry.pos.ToString());
+        }
+        if (block.GetHash() != entry.index->GetBlockHash()) {
+            return error("%s: block at %s is not %s", __func__, entry.pos.ToString(), entry.index->GetBlockHash().ToString());
+        }
+        ++job.stats.blocks;
+        const int height = entry.index->nHeight;
+
+        for (const CTransactionRef& tx : block.vtx) {
+            if (tx->strFloData.empty()) continue;
+            ++job.stats.transactions;
+            if (format == FloDataExportFormat::BINARY) {
+                CVectorWriter(SER_DISK, CLIENT_VERSION, job.output, job.output.size()) << tx->GetHash() << height << tx->strFloData;
+            } else {
+                const std::string line = strprintf("{\"txid\":\"%s\",\"height\":%d,\"floData\":%s}\n",
+                                                   tx->GetHash().GetHex(), height, UniValue(tx->strFloData).write());
+                job.output.insert(job.output.end(), line.begin(), line.end());
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool ExportFloData(const std::vector<FloDataExportBlock>& blocks, FloDataExportFormat format, int threads,
+                   FILE* file, FloDataExportStats& stats, const std::function<bool()>& interrupt)
+{
+    std::map<int, BlockFileJob> jobs_by_file;
+    for (const FloDataExportBlock& entry : blocks) {
+        jobs_by_file[entry.pos.nFile].blocks.push_back(entry);
+    }
+    std::vector<BlockFileJob> jobs;
+    jobs.reserve(jobs_by_file.size());
+    for (auto& [n_file, job] : jobs_by_file) {
+        std::sort(job.blocks.begin(), job.blocks.end(), [](const FloDataExportBlock& a, const FloDataExportBlock& b) {
+            return a.pos.nPos < b.pos.nPos;
+        });
+        jobs.push_back(std::move(job));
+    }
+
+    threads = std::max(threads, 1);
+    // Bound the output held in memory while an earlier file is still read.
+    const size_t max_jobs_ahead = 2 * threads;
+
+    Mutex mutex;
+    std::condition_variable cond;
+    std::atomic<size_t> next_job{0};
+    size_t jobs_written{0};
+    std::atomic<bool> abort{false};
+
+    auto work = [&] {
+        while (!abort) {
+            const size_t i = next_job++;
+            if (i >= jobs.size()) break;
+            {
+                WAIT_LOCK(mutex, lock);
+                cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(mutex) { return abort || i < jobs_written + max_jobs_ahead; });
+            }
+            if (abort) break;
+            const bool ok = ExportBlockFile(jobs[i], format, abort);
+            if (!ok) abort = true;
+            WITH_LOCK(mutex, jobs[i].state = ok ? BlockFileJob::DONE : BlockFileJob::FAILED);
+            cond.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int n = 0; n < threads && (size_t)n < jobs.size(); ++n) {
+        workers.emplace_back([&, n] {
+            util::ThreadRename(strprintf("flodata.%i", n));
+            work();
+        });
+    }
+
+    // Write the output of each block file as soon as it and all files before it are done.
+    for (size_t i = 0; i < jobs.size() && !abort; ++i) {
+        {
+            WAIT_LOCK(mutex, lock);
+            while (!abort) {
+                if (interrupt()) {
+                    abort = true;
+                } else if (jobs[i].state == BlockFileJob::PENDING) {
+                    cond.wait_for(lock, std::chrono::milliseconds{100});
+                } else {
+                    break;
+                }
+            }
+            if (abort || jobs[i].state != BlockFileJob::DONE) break;
+        }
+        if (fwrite(jobs[i].output.data(), 1, jobs[i].output.size(), file) != jobs[i].output.size()) {
+            error("%s: failed to write output", __func__);
+            abort = true;
+            break;
+        }
+        stats.blocks += jobs[i].stats.blocks;
+        stats.transactions += jobs[i].stats.transactions;
+        std::vector<unsigned char>().swap(jobs[i].output);
+        WITH_LOCK(mutex, ++jobs_written);
+        cond.notify_all();
+    }
+
+    // Wake up the workers waiting for their turn after a failure. Taking the
+    // mutex makes sure that those which checked abort before it was set are
+    // waiting by now.
+    {
+        LOCK(mutex);
+    }
+    cond.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return !abort;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_NODE_FLODATAEXPORT_H
+#define FLOCOIN_NODE_FLODATAEXPORT_H
+
+#include <flatfile.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+class CBlockIndex;
+
+/** A block to export, and its position in the block files when it was chosen. */
+struct FloDataExportBlock {
+    const CBlockIndex* index;
+    FlatFilePos pos;
+};
+
+enum class FloDataExportFormat {
+    //! txid (32 bytes), height (4 bytes LE), then floData as a CompactSize-prefixed string
+    BINARY,
+    //! One {"txid","height","floData"} JSON object per line
+    NDJSON,
+};
+
+struct FloDataExportStats {
+    uint64_t blocks{0};
+    uint64_t transactions{0};
+};
+
+/**
+ * Write the txid, height and floData of every transaction carrying floData in
+ * the given blocks to file. Blocks are read straight from the block files:
+ * each worker thread takes a whole blk?????.dat file at a time and reads its
+ * blocks in file order. At most two files per thread are read ahead of the
+ * one being written out.
+ *
+ * Records are written in order of their position in the block files, not in
+ * height order: blocks downloaded out of order are stored out of order.
+ *
+ * @param[in] interrupt  polled while exporting; the export is aborted if it returns true
+ * @returns false if a block was pruned or could not be read, the file could not
+ *          be written, or the export was interrupted
+ */
+bool ExportFloData(const std::vector<FloDataExportBlock>& blocks, FloDataExportFormat format, int threads,
+                   FILE* file, FloDataExportStats& stats, const std::function<bool()>& interrupt);
+
+#endif // FLOCOIN_NODE_FLODATAEXPORT_H
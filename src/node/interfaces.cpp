@@ -18,6 +18,7 @@
 #include <net_processing.h>
 #include <netaddress.h>
 #include <netbase.h>
+#include <node/blockprefetcher.h>
 #include <node/blockstorage.h>
 #include <node/coin.h>
 #include <node/context.h>
@@ -57,6 +58,7 @@
 
 #include <boost/signals2/signal.hpp>
 
+using interfaces::BlockReader;
 using interfaces::BlockTip;
 using interfaces::Chain;
 using interfaces::FoundBlock;
@@ -337,6 +339,31 @@ bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<Rec
     return true;
 }
 
+class BlockReaderImpl : public BlockReader
+{
+public:
+    explicit BlockReaderImpl(ChainstateManager& chainman)
+        : m_chainman(chainman), m_prefetcher(Params().GetConsensus(), g_block_prefetch > 0 ? BLOCK_PREFETCH_THREADS : 0) {}
+    bool readBlock(const uint256& hash, CBlock& block) override
+    {
+        const CBlockIndex* index;
+        {
+            LOCK(cs_main);
+            index = m_chainman.m_blockman.LookupBlockIndex(hash);
+            if (!index) return false;
+            m_prefetcher.Prefetch(m_chainman.ActiveChain(), index, g_block_prefetch);
+        }
+        if (std::shared_ptr<const CBlock> prefetched = m_prefetcher.Get(hash)) {
+            block = *prefetched;
+        } else if (!ReadBlockFromDisk(block, index, Params().GetConsensus())) {
+            block.SetNull();
+        }
+        return true;
+    }
+    ChainstateManager& m_chainman;
+    BlockPrefetcher m_prefetcher;
+};
+
 class NotificationsProxy : public CValidationInterface
 {
 public:
@@ -482,6 +509,10 @@ public:
         const CChain& active = Assert(m_node.chainman)->ActiveChain();
         return FillBlock(m_node.chainman->m_blockman.LookupBlockIndex(hash), block, lock, active);
     }
+    std::unique_ptr<BlockReader> makeBlockReader() override
+    {
+        return std::make_unique<BlockReaderImpl>(chainman());
+    }
     bool findFirstBlockWithTimeAndHeight(int64_t min_time, int min_height, const FoundBlock& block) override
     {
         WAIT_LOCK(cs_main, lock);
@@ -0,0 +1,126 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/powaudit.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <logging.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/system.h>
+#include <util/threadnames.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <set>
+
+extern std::set<CBlockIndex*> setDirtyBlockIndex;
+
+//! Number of headers handed to the multi-buffer scrypt kernel at once.
+static constexpr size_t AUDIT_BATCH_SIZE{512};
+
+PoWAudit::~PoWAudit()
+{
+    Stop();
+}
+
+void PoWAudit::Start(int threads_num)
+{
+    assert(m_worker_threads.empty());
+    {
+        LOCK(cs_main);
+        m_entries.reserve(m_chainman.BlockIndex().size());
+        for (const auto& entry : m_chainman.BlockIndex()) {
+            m_entries.push_back(entry.second);
+        }
+    }
+    LogPrintf("Auditing the proof of work of %u block index entries in the background using %d threads\n", m_entries.size(), threads_num);
+    m_running = threads_num;
+    for (int n = 0; n < threads_num; ++n) {
+        m_worker_threads.emplace_back([this, n]() {
+            util::ThreadRename(strprintf("powaudit.%i", n));
+            ThreadAudit();
+        });
+    }
+}
+
+void PoWAudit::Stop()
+{
+    m_interrupt = true;
+    for (std::thread& t : m_worker_threads) {
+        t.join();
+    }
+    m_worker_threads.clear();
+}
+
+PoWAudit::Progress PoWAudit::GetProgress() const
+{
+    Progress progress;
+    progress.total = m_entries.size();
+    progress.checked = m_checked;
+    progress.corrupt = m_corrupt;
+    progress.running = m_running > 0;
+    return progress;
+}
+
+void PoWAudit::ThreadAudit()
+{
+    ScheduleIdlePriority();
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    std::vector<CBlockHeader> headers;
+    std::vector<CBlockIndex*> corrupt;
+    while (!m_interrupt) {
+        const size_t start = m_next.fetch_add(AUDIT_BATCH_SIZE);
+        if (start >= m_entries.size()) break;
+        const size_t end = std::min(start + AUDIT_BATCH_SIZE, m_entries.size());
+
+        headers.clear();
+        {
+            LOCK(cs_main);
+            for (size_t i = start; i < end; ++i) {
+                headers.push_back(m_entries[i]->GetBlockHeader());
+            }
+        }
+        const std::vector<uint256> pow_hashes = GetPoWHashes(headers);
+        {
+            LOCK(cs_main);
+            for (size_t i = start; i < end; ++i) {
+                CBlockIndex* pindex = m_entries[i];
+                const uint256& pow_hash = pow_hashes[i - start];
+                if (!CheckProofOfWork(pow_hash, pindex->nBits, consensusParams)) {
+                    corrupt.push_back(pindex);
+                    continue;
+                }
+                if (!(pindex->nStatus & BLOCK_HAVE_POW_HASH) || pindex->hashPoW != pow_hash) {
+                    if (pindex->nStatus & BLOCK_HAVE_POW_HASH) {
+                        LogPrintf("%s: repairing stored proof-of-work hash of block %s\n", __func__, pindex->GetBlockHash().ToString());
+                    }
+                    pindex->SetBlockPoWHash(pow_hash);
+                    setDirtyBlockIndex.insert(pindex);
+                }
+            }
+        }
+        m_checked += end - start;
+
+        // InvalidateBlock() takes cs_main itself, and may need to rewind the active chain.
+        for (CBlockIndex* pindex : corrupt) {
+            LogPrintf("ERROR: %s: block %s at height %d fails its proof of work, marking it invalid\n", __func__, pindex->GetBlockHash().ToString(), pindex->nHeight);
+            ++m_corrupt;
+            BlockValidationState state;
+            if (!m_chainman.ActiveChainstate().InvalidateBlock(state, pindex)) {
+                LogPrintf("ERROR: %s: failed to invalidate block %s: %s\n", __func__, pindex->GetBlockHash().ToString(), state.ToString());
+            }
+        }
+        corrupt.clear();
+    }
+
+    if (--m_running == 0 && !m_interrupt) {
+        LogPrintf("Block index proof-of-work audit finished: %u entries checked, %u corrupt\n", m_checked.load(), m_corrupt.load());
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_NODE_POWAUDIT_H
+#define FLOCOIN_NODE_POWAUDIT_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+class CBlockIndex;
+class ChainstateManager;
+
+static constexpr bool DEFAULT_POWAUDIT{false};
+
+/**
+ * Re-verifies the scrypt proof of work of the whole block index in the
+ * background, since LoadBlockIndexGuts() cannot afford to recompute every
+ * scrypt hash at startup. Runs at idle priority on any number of threads.
+ *
+ * Entries whose header fails its proof of work are invalidated. Missing or
+ * mismatching stored proof-of-work hashes are (re)written.
+ */
+class PoWAudit
+{
+public:
+    struct Progress {
+        uint64_t total{0};
+        uint64_t checked{0};
+        uint64_t corrupt{0};
+        bool running{false};
+    };
+
+    explicit PoWAudit(ChainstateManager& chainman) : m_chainman(chainman) {}
+    ~PoWAudit();
+
+    //! Snapshot the block index and start auditing it with threads_num worker threads.
+    void Start(int threads_num);
+
+    //! Interrupt the audit and wait for the worker threads to exit.
+    void Stop();
+
+    Progress GetProgress() const;
+
+private:
+    void ThreadAudit();
+
+    ChainstateManager& m_chainman;
+    std::vector<CBlockIndex*> m_entries;
+    std::vector<std::thread> m_worker_threads;
+    std::atomic<size_t> m_next{0};
+    std::atomic<uint64_t> m_checked{0};
+    std::atomic<uint64_t> m_corrupt{0};
+    std::atomic<int> m_running{0};
+    std::atomic_bool m_interrupt{false};
+};
+
+#endif // FLOCOIN_NODE_POWAUDIT_H
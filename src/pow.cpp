@@ -46,10 +46,8 @@ unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHead
         blockstogoback = averagingInterval;
 
     // Go back by what we want to be 14 days worth of blocks
-    const CBlockIndex* pindexFirst = pindexLast;
-    for (int i = 0; pindexFirst && i < blockstogoback; i++)
-        pindexFirst = pindexFirst->pprev;
-        
+    // Use the skip list rather than walking pprev, as this runs for every header.
+    const CBlockIndex* pindexFirst = pindexLast->GetAncestor(pindexLast->nHeight - blockstogoback);
     assert(pindexFirst);
 
     return CalculateNextWorkRequired(pindexLast, pindexFirst->GetBlockTime(), params);
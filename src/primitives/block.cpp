@@ -12,6 +12,8 @@
 #include <tinyformat.h>
 #include <crypto/scrypt.h>
 
+#include <string.h>
+
 
 uint256 CBlockHeader::GetHash() const
 {
@@ -25,6 +27,18 @@ uint256 CBlockHeader::GetPoWHash() const
     return thash;
 }
 
+std::vector<uint256> GetPoWHashes(Span<const CBlockHeader> headers)
+{
+    static_assert(sizeof(uint256) == 32, "scrypt_1024_1_1_256_multi writes packed 32-byte hashes");
+    std::vector<char> input(headers.size() * 80);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        memcpy(&input[i * 80], BEGIN(headers[i].nVersion), 80);
+    }
+    std::vector<uint256> hashes(headers.size());
+    scrypt_1024_1_1_256_multi(input.data(), (char*)hashes.data(), headers.size());
+    return hashes;
+}
+
 std::string CBlock::ToString() const
 {
     std::stringstream s;
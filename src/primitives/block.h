@@ -8,6 +8,7 @@
 
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <span.h>
 #include <uint256.h>
 
 /** Nodes collect new transactions into a block, hash them into a hash tree,
@@ -61,6 +62,11 @@ public:
 };
 
 
+/** Compute the scrypt proof-of-work hashes of a batch of headers, using the
+ *  multi-buffer scrypt kernels where available. */
+std::vector<uint256> GetPoWHashes(Span<const CBlockHeader> headers);
+
+
 class CBlock : public CBlockHeader
 {
 public:
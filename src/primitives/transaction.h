@@ -13,6 +13,8 @@
 #include <serialize.h>
 #include <uint256.h>
 
+#include <memory>
+#include <string>
 #include <tuple>
 
 /**
@@ -166,6 +168,54 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * The floData of a transaction. It is immutable and shared by the copies of a
+ * transaction, so that converting between CMutableTransaction and CTransaction
+ * does not copy it. Empty floData needs no allocation.
+ */
+class FloData
+{
+private:
+    std::shared_ptr<const std::string> m_data;
+
+public:
+    FloData() = default;
+    FloData(std::string data) : m_data(data.empty() ? nullptr : std::make_shared<const std::string>(std::move(data))) {}
+    FloData(const char* data) : FloData(std::string(data)) {}
+
+    const std::string& str() const
+    {
+        static const std::string empty;
+        return m_data ? *m_data : empty;
+    }
+    operator const std::string&() const { return str(); }
+
+    bool empty() const { return !m_data; }
+    size_t size() const { return str().size(); }
+    size_t length() const { return str().size(); }
+    const char* data() const { return str().data(); }
+
+    friend bool operator==(const FloData& a, const FloData& b) { return a.str() == b.str(); }
+    friend bool operator!=(const FloData& a, const FloData& b) { return !(a == b); }
+
+    //! The shared buffer, or null if the floData is empty.
+    const std::shared_ptr<const std::string>& GetShared() const { return m_data; }
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << str();
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        std::string data;
+        s >> data;
+        *this = FloData(std::move(data));
+    }
+};
+
 struct CMutableTransaction;
 
 /**
@@ -280,7 +330,7 @@ public:
     const std::vector<CTxOut> vout;
     const int32_t nVersion;
     const uint32_t nLockTime;
-    const std::string strFloData;
+    const FloData strFloData;
 
 private:
     /** Memory only. */
@@ -357,7 +407,7 @@ struct CMutableTransaction
     std::vector<CTxOut> vout;
     int32_t nVersion;
     uint32_t nLockTime;
-    std::string strFloData;
+    FloData strFloData;
 
     CMutableTransaction();
     explicit CMutableTransaction(const CTransaction& tx);
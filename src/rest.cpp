@@ -4,9 +4,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chain.h>
+#include <blockfilter.h>
 #include <chainparams.h>
 #include <core_io.h>
 #include <httpserver.h>
+#include <index/blockfilterindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
@@ -30,6 +32,8 @@
 #include <univalue.h>
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static const long MAX_REST_HEADERS_RESULTS = 2000; //allow a max of 2000 headers or filter headers to be queried at once
+static const long MAX_REST_FLODATA_BLOCKS = 1000; //allow a max of 1000 blocks to be scanned for floData at once
 
 enum class RetFormat {
     UNDEF,
@@ -190,7 +194,7 @@ static bool rest_headers(const std::any& context,
         return RESTERR(req, HTTP_BAD_REQUEST, "No header count specified. Use /rest/headers/<count>/<hash>.<ext>.");
 
     long count = strtol(path[0].c_str(), nullptr, 10);
-    if (count < 1 || count > 2000)
+    if (count < 1 || count > MAX_REST_HEADERS_RESULTS)
         return RESTERR(req, HTTP_BAD_REQUEST, "Header count out of range: " + path[0]);
 
     std::string hashStr = path[1];
@@ -257,6 +261,201 @@ static bool rest_headers(const std::any& context,
     }
 }
 
+static bool rest_filter_header(const std::any& context,
+                               HTTPRequest* req,
+                               const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 3)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Use /rest/blockfilterheaders/<filtertype>/<count>/<hash>.<ext>.");
+
+    BlockFilterType filter_type;
+    if (!BlockFilterTypeByName(path[0], filter_type))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Unknown filtertype " + path[0]);
+
+    BlockFilterIndex* index = GetBlockFilterIndex(filter_type);
+    if (!index)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Index is not enabled for filtertype " + path[0]);
+
+    long count = strtol(path[1].c_str(), nullptr, 10);
+    if (count < 1 || count > MAX_REST_HEADERS_RESULTS)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Header count out of range: " + path[1]);
+
+    std::string hashStr = path[2];
+    uint256 hash;
+    if (!ParseHashStr(hashStr, hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+
+    std::vector<const CBlockIndex*> headers;
+    headers.reserve(count);
+    {
+        ChainstateManager* maybe_chainman = GetChainman(context, req);
+        if (!maybe_chainman) return false;
+        ChainstateManager& chainman = *maybe_chainman;
+        LOCK(cs_main);
+        CChain& active_chain = chainman.ActiveChain();
+        const CBlockIndex* pindex = chainman.m_blockman.LookupBlockIndex(hash);
+        while (pindex != nullptr && active_chain.Contains(pindex)) {
+            headers.push_back(pindex);
+            if (headers.size() == (unsigned long)count)
+                break;
+            pindex = active_chain.Next(pindex);
+        }
+    }
+
+    bool index_ready = index->BlockUntilSyncedToCurrentChain();
+
+    std::vector<uint256> filter_headers;
+    filter_headers.reserve(headers.size());
+    for (const CBlockIndex* pindex : headers) {
+        uint256 filter_header;
+        if (!index->LookupFilterHeader(pindex, filter_header)) {
+            std::string errmsg = "Filter not found.";
+            if (!index_ready) {
+                errmsg += " Block filters are still in the process of being indexed.";
+            } else {
+                errmsg += " This error is unexpected and indicates index corruption.";
+            }
+            return RESTERR(req, HTTP_NOT_FOUND, errmsg);
+        }
+        filter_headers.push_back(filter_header);
+    }
+
+    switch (rf) {
+    case RetFormat::BINARY: {
+        CDataStream ssHeader(SER_NETWORK, PROTOCOL_VERSION);
+        for (const uint256& header : filter_headers) {
+            ssHeader << header;
+        }
+
+        std::string binaryHeader = ssHeader.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryHeader);
+        return true;
+    }
+    case RetFormat::HEX: {
+        CDataStream ssHeader(SER_NETWORK, PROTOCOL_VERSION);
+        for (const uint256& header : filter_headers) {
+            ssHeader << header;
+        }
+
+        std::string strHex = HexStr(ssHeader) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+    case RetFormat::JSON: {
+        UniValue jsonHeaders(UniValue::VARR);
+        for (const uint256& header : filter_headers) {
+            jsonHeaders.push_back(header.GetHex());
+        }
+
+        std::string strJSON = jsonHeaders.write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: .bin, .hex, .json)");
+    }
+    }
+}
+
+static bool rest_block_filter(const std::any& context,
+                              HTTPRequest* req,
+                              const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 2)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Use /rest/blockfilter/<filtertype>/<hash>.<ext>.");
+
+    BlockFilterType filter_type;
+    if (!BlockFilterTypeByName(path[0], filter_type))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Unknown filtertype " + path[0]);
+
+    BlockFilterIndex* index = GetBlockFilterIndex(filter_type);
+    if (!index)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Index is not enabled for filtertype " + path[0]);
+
+    std::string hashStr = path[1];
+    uint256 hash;
+    if (!ParseHashStr(hashStr, hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+
+    const CBlockIndex* pblockindex = nullptr;
+    bool block_was_connected;
+    {
+        ChainstateManager* maybe_chainman = GetChainman(context, req);
+        if (!maybe_chainman) return false;
+        ChainstateManager& chainman = *maybe_chainman;
+        LOCK(cs_main);
+        pblockindex = chainman.m_blockman.LookupBlockIndex(hash);
+        if (!pblockindex)
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        block_was_connected = pblockindex->IsValid(BLOCK_VALID_SCRIPTS);
+    }
+
+    bool index_ready = index->BlockUntilSyncedToCurrentChain();
+
+    BlockFilter filter;
+    if (!index->LookupFilter(pblockindex, filter)) {
+        std::string errmsg = "Filter not found.";
+        if (!block_was_connected) {
+            errmsg += " Block was not connected to active chain.";
+        } else if (!index_ready) {
+            errmsg += " Block filters are still in the process of being indexed.";
+        } else {
+            errmsg += " This error is unexpected and indicates index corruption.";
+        }
+        return RESTERR(req, HTTP_NOT_FOUND, errmsg);
+    }
+
+    switch (rf) {
+    case RetFormat::BINARY: {
+        CDataStream ssFilter(SER_NETWORK, PROTOCOL_VERSION);
+        ssFilter << filter;
+
+        std::string binaryFilter = ssFilter.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryFilter);
+        return true;
+    }
+    case RetFormat::HEX: {
+        CDataStream ssFilter(SER_NETWORK, PROTOCOL_VERSION);
+        ssFilter << filter;
+
+        std::string strHex = HexStr(ssFilter) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+    case RetFormat::JSON: {
+        UniValue ret(UniValue::VOBJ);
+        ret.pushKV("filter", HexStr(filter.GetEncodedFilter()));
+
+        std::string strJSON = ret.write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: .bin, .hex, .json)");
+    }
+    }
+}
+
 static bool rest_block(const std::any& context,
                        HTTPRequest* req,
                        const std::string& strURIPart,
@@ -708,6 +907,93 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_flodata(const std::any& context, HTTPRequest* req,
+                         const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, str_uri_part);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 2) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "No block count specified. Use /rest/flodata/<start_height>/<count>.<ext>.");
+    }
+
+    int32_t start_height = -1;
+    if (!ParseInt32(path[0], &start_height) || start_height < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(path[0]));
+    }
+    long count = strtol(path[1].c_str(), nullptr, 10);
+    if (count < 1 || count > MAX_REST_FLODATA_BLOCKS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Block count out of range: " + SanitizeString(path[1]));
+    }
+
+    std::vector<const CBlockIndex*> blocks;
+    {
+        ChainstateManager* maybe_chainman = GetChainman(context, req);
+        if (!maybe_chainman) return false;
+        ChainstateManager& chainman = *maybe_chainman;
+        LOCK(cs_main);
+        const CChain& active_chain = chainman.ActiveChain();
+        if (start_height > active_chain.Height()) {
+            return RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
+        }
+        for (int height = start_height; height <= active_chain.Height() && (long)blocks.size() < count; ++height) {
+            const CBlockIndex* pblockindex = active_chain[height];
+            if (IsBlockPruned(pblockindex)) {
+                return RESTERR(req, HTTP_NOT_FOUND, pblockindex->GetBlockHash().GetHex() + " not available (pruned data)");
+            }
+            blocks.push_back(pblockindex);
+        }
+    }
+
+    // Only the floData carrying transactions are kept, so whole blocks are
+    // never serialized.
+    CDataStream ss_flodata(SER_NETWORK, PROTOCOL_VERSION);
+    UniValue flodata(UniValue::VARR);
+    for (const CBlockIndex* pblockindex : blocks) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
+            return RESTERR(req, HTTP_NOT_FOUND, pblockindex->GetBlockHash().GetHex() + " not found");
+        }
+        for (const CTransactionRef& tx : block.vtx) {
+            if (tx->strFloData.empty()) continue;
+            if (rf == RetFormat::JSON) {
+                UniValue entry(UniValue::VOBJ);
+                entry.pushKV("txid", tx->GetHash().GetHex());
+                entry.pushKV("height", pblockindex->nHeight);
+                entry.pushKV("vouts", (uint64_t)tx->vout.size());
+                entry.pushKV("floData", tx->strFloData);
+                flodata.push_back(entry);
+            } else {
+                ss_flodata << tx->GetHash() << pblockindex->nHeight << COMPACTSIZE(tx->vout.size()) << tx->strFloData;
+            }
+        }
+    }
+
+    switch (rf) {
+    case RetFormat::BINARY: {
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, ss_flodata.str());
+        return true;
+    }
+    case RetFormat::HEX: {
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, HexStr(ss_flodata) + "\n");
+        return true;
+    }
+    case RetFormat::JSON: {
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, flodata.write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: .bin, .hex, .json)");
+    }
+    }
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -719,8 +1005,11 @@ static const struct {
       {"/rest/mempool/info", rest_mempool_info},
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
+      {"/rest/blockfilterheaders/", rest_filter_header},
+      {"/rest/blockfilter/", rest_block_filter},
       {"/rest/getutxos", rest_getutxos},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/flodata/", rest_flodata},
 };
 
 void StartREST(const std::any& context)
@@ -19,9 +19,12 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/flodataindex.h>
 #include <node/blockstorage.h>
 #include <node/coinstats.h>
 #include <node/context.h>
+#include <node/flodataexport.h>
+#include <node/powaudit.h>
 #include <node/utxo_snapshot.h>
 #include <policy/feerate.h>
 #include <policy/fees.h>
@@ -31,6 +34,7 @@
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
+#include <shutdown.h>
 #include <streams.h>
 #include <sync.h>
 #include <txdb.h>
@@ -49,6 +53,7 @@
 #include <univalue.h>
 
 #include <condition_variable>
+#include <limits>
 #include <memory>
 #include <mutex>
 
@@ -1238,6 +1243,69 @@ static RPCHelpMan gettxoutsetinfo()
     };
 }
 
+static RPCHelpMan getcoinscacheinfo()
+{
+    return RPCHelpMan{"getcoinscacheinfo",
+                "\nReturns details on the in-memory cache of the UTXO set of the active chainstate,\n"
+                "including how well it answers lookups before and after it is flushed to disk.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "coins", "Number of coins in the cache"},
+                        {RPCResult::Type::NUM, "usage", "Memory usage of the cache in bytes"},
+                        {RPCResult::Type::NUM, "max_usage", "Memory usage above which the cache is flushed in bytes, not counting unused mempool memory"},
+                        {RPCResult::Type::NUM, "flushes", "Number of times the cache was flushed"},
+                        {RPCResult::Type::NUM, "coins_kept", "Number of coins the last flush kept in the cache (see -dbcachekeep)"},
+                        {RPCResult::Type::OBJ, "since_flush", "Lookups since the last flush",
+                        {
+                            {RPCResult::Type::NUM, "hits", "Lookups answered by the cache"},
+                            {RPCResult::Type::NUM, "misses", "Lookups that had to read the coins database"},
+                            {RPCResult::Type::NUM, "warmed", "Coins read ahead of their lookups while connecting blocks (see -blockprefetch), which would otherwise have been misses"},
+                            {RPCResult::Type::NUM, "hitrate", "Fraction of lookups answered by the cache"},
+                        }},
+                        {RPCResult::Type::OBJ, "before_flush", "Lookups between the last two flushes",
+                        {
+                            {RPCResult::Type::NUM, "hits", "Lookups answered by the cache"},
+                            {RPCResult::Type::NUM, "misses", "Lookups that had to read the coins database"},
+                            {RPCResult::Type::NUM, "warmed", "Coins read ahead of their lookups while connecting blocks (see -blockprefetch), which would otherwise have been misses"},
+                            {RPCResult::Type::NUM, "hitrate", "Fraction of lookups answered by the cache"},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getcoinscacheinfo", "")
+            + HelpExampleRpc("getcoinscacheinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+    CChainState& chainstate = chainman.ActiveChainstate();
+    const CCoinsViewCache& coins_tip = chainstate.CoinsTip();
+    const CCoinsCacheStats stats = coins_tip.GetStats();
+
+    auto lookups = [](uint64_t hits, uint64_t misses, uint64_t warmed) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("hits", hits);
+        obj.pushKV("misses", misses);
+        obj.pushKV("warmed", warmed);
+        obj.pushKV("hitrate", hits + misses > 0 ? double(hits) / (hits + misses) : 0.0);
+        return obj;
+    };
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("coins", (uint64_t)coins_tip.GetCacheSize());
+    ret.pushKV("usage", (uint64_t)coins_tip.DynamicMemoryUsage());
+    ret.pushKV("max_usage", (uint64_t)chainstate.m_coinstip_cache_size_bytes);
+    ret.pushKV("flushes", stats.flushes);
+    ret.pushKV("coins_kept", stats.coins_kept);
+    ret.pushKV("since_flush", lookups(stats.hits, stats.misses, stats.warmed));
+    ret.pushKV("before_flush", lookups(stats.hits_before_flush, stats.misses_before_flush, stats.warmed_before_flush));
+    return ret;
+},
+    };
+}
+
 static RPCHelpMan gettxout()
 {
     return RPCHelpMan{"gettxout",
@@ -1465,6 +1533,14 @@ RPCHelpMan getblockchaininfo()
                                 {RPCResult::Type::BOOL, "active", "true if the rules are enforced for the mempool and the next block"},
                             }},
                         }},
+                        {RPCResult::Type::OBJ, "powaudit", /* optional */ true, "progress of the background proof-of-work audit (only present if -powaudit is enabled)",
+                        {
+                            {RPCResult::Type::NUM, "total", "the number of block index entries to audit"},
+                            {RPCResult::Type::NUM, "checked", "the number of entries audited so far"},
+                            {RPCResult::Type::NUM, "corrupt", "the number of entries that failed their proof of work and were invalidated"},
+                            {RPCResult::Type::NUM, "progress", "estimate of audit progress [0..1]"},
+                            {RPCResult::Type::BOOL, "running", "whether the audit is still running"},
+                        }},
                         {RPCResult::Type::STR, "warnings", "any network and blockchain warnings"},
                     }},
                 RPCExamples{
@@ -1521,6 +1597,18 @@ RPCHelpMan getblockchaininfo()
     SoftForkDescPushBack(tip, softforks, consensusParams, Consensus::DEPLOYMENT_TAPROOT);
     obj.pushKV("softforks", softforks);
 
+    const NodeContext& node = EnsureAnyNodeContext(request.context);
+    if (node.pow_audit) {
+        const PoWAudit::Progress progress = node.pow_audit->GetProgress();
+        UniValue audit(UniValue::VOBJ);
+        audit.pushKV("total",    progress.total);
+        audit.pushKV("checked",  progress.checked);
+        audit.pushKV("corrupt",  progress.corrupt);
+        audit.pushKV("progress", progress.total ? (double)progress.checked / progress.total : 1.0);
+        audit.pushKV("running",  progress.running);
+        obj.pushKV("powaudit", audit);
+    }
+
     obj.pushKV("warnings", GetWarnings(false).original);
     return obj;
 },
@@ -1954,6 +2042,36 @@ static inline bool SetHasKeys(const std::set<T>& set, const Tk& key, const Args&
 // outpoint (needed for the utxo index) + nHeight + fCoinBase
 static constexpr size_t PER_UTXO_OVERHEAD = sizeof(COutPoint) + sizeof(uint32_t) + sizeof(bool);
 
+static void PushFloDataStats(UniValue& ret, const FloDataBlockStats& stats)
+{
+    UniValue prefixes(UniValue::VOBJ);
+    for (const auto& [prefix, count] : stats.prefixes) {
+        prefixes.pushKV(prefix, count);
+    }
+    ret.pushKV("flodata_maxsize", stats.max_size);
+    ret.pushKV("flodata_prefixes", prefixes);
+    ret.pushKV("flodata_total_size", stats.total_bytes);
+    ret.pushKV("flodata_txs", stats.count);
+}
+
+/** Keep the selected statistics of ret_all, or all of them if none are selected. */
+static UniValue SelectBlockStats(const UniValue& ret_all, const std::set<std::string>& stats)
+{
+    if (stats.empty()) {
+        return ret_all;
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    for (const std::string& stat : stats) {
+        const UniValue& value = ret_all[stat];
+        if (value.isNull()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid selected statistic %s", stat));
+        }
+        ret.pushKV(stat, value);
+    }
+    return ret;
+}
+
 static RPCHelpMan getblockstats()
 {
     return RPCHelpMan{"getblockstats",
@@ -1983,6 +2101,13 @@ static RPCHelpMan getblockstats()
                     {RPCResult::Type::NUM, "75th_percentile_feerate", "The 75th percentile feerate"},
                     {RPCResult::Type::NUM, "90th_percentile_feerate", "The 90th percentile feerate"},
                 }},
+                {RPCResult::Type::NUM, "flodata_maxsize", "Maximum floData size"},
+                {RPCResult::Type::OBJ_DYN, "flodata_prefixes", "The number of floData per application prefix, i.e. up to the first ':' within the first " + ToString(FLODATA_INDEX_PREFIX_SIZE) + " bytes (\"\" if none)",
+                {
+                    {RPCResult::Type::NUM, "prefix", "The number of floData with this prefix"},
+                }},
+                {RPCResult::Type::NUM, "flodata_total_size", "Total size of all floData"},
+                {RPCResult::Type::NUM, "flodata_txs", "The number of transactions with floData (including coinbase)"},
                 {RPCResult::Type::NUM, "height", "The height of the block"},
                 {RPCResult::Type::NUM, "ins", "The number of inputs (excluding coinbase)"},
                 {RPCResult::Type::NUM, "maxfee", "Maximum fee in the block"},
@@ -2030,10 +2155,24 @@ static RPCHelpMan getblockstats()
         }
     }
 
+    const bool do_all = stats.size() == 0; // Calculate everything if nothing selected (default)
+
+    // floData statistics can be served from the floData index without reading the block.
+    FloDataBlockStats flo_data_stats;
+    const bool flo_data_only = !do_all && std::all_of(stats.begin(), stats.end(), [](const std::string& stat) {
+        return stat.rfind("flodata_", 0) == 0 || stat == "blockhash" || stat == "height";
+    });
+    if (flo_data_only && g_flodataindex && g_flodataindex->LookUpBlockStats(pindex, flo_data_stats)) {
+        UniValue ret_all(UniValue::VOBJ);
+        ret_all.pushKV("blockhash", pindex->GetBlockHash().GetHex());
+        ret_all.pushKV("height", (int64_t)pindex->nHeight);
+        PushFloDataStats(ret_all, flo_data_stats);
+        return SelectBlockStats(ret_all, stats);
+    }
+
     const CBlock block = GetBlockChecked(pindex);
     const CBlockUndo blockUndo = GetUndoChecked(pindex);
 
-    const bool do_all = stats.size() == 0; // Calculate everything if nothing selected (default)
     const bool do_mediantxsize = do_all || stats.count("mediantxsize") != 0;
     const bool do_medianfee = do_all || stats.count("medianfee") != 0;
     const bool do_feerate_percentiles = do_all || stats.count("feerate_percentiles") != 0;
@@ -2068,6 +2207,7 @@ static RPCHelpMan getblockstats()
     for (size_t i = 0; i < block.vtx.size(); ++i) {
         const auto& tx = block.vtx.at(i);
         outputs += tx->vout.size();
+        flo_data_stats.Add(tx->strFloData);
 
         CAmount tx_total_out = 0;
         if (loop_outputs) {
@@ -2151,6 +2291,7 @@ static RPCHelpMan getblockstats()
     ret_all.pushKV("avgtxsize", (block.vtx.size() > 1) ? total_size / (block.vtx.size() - 1) : 0);
     ret_all.pushKV("blockhash", pindex->GetBlockHash().GetHex());
     ret_all.pushKV("feerate_percentiles", feerates_res);
+    PushFloDataStats(ret_all, flo_data_stats);
     ret_all.pushKV("height", (int64_t)pindex->nHeight);
     ret_all.pushKV("ins", inputs);
     ret_all.pushKV("maxfee", maxfee);
@@ -2176,19 +2317,7 @@ static RPCHelpMan getblockstats()
     ret_all.pushKV("utxo_increase", outputs - inputs);
     ret_all.pushKV("utxo_size_inc", utxo_size_inc);
 
-    if (do_all) {
-        return ret_all;
-    }
-
-    UniValue ret(UniValue::VOBJ);
-    for (const std::string& stat : stats) {
-        const UniValue& value = ret_all[stat];
-        if (value.isNull()) {
-            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid selected statistic %s", stat));
-        }
-        ret.pushKV(stat, value);
-    }
-    return ret;
+    return SelectBlockStats(ret_all, stats);
 },
     };
 }
@@ -2446,7 +2575,7 @@ static RPCHelpMan getblockfilter()
                 "\nRetrieve a BIP 157 content filter for a particular block.\n",
                 {
                     {"blockhash", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The hash of the block"},
-                    {"filtertype", RPCArg::Type::STR, RPCArg::Default{"basic"}, "The type name of the filter"},
+                    {"filtertype", RPCArg::Type::STR, RPCArg::Default{"basic"}, "The type name of the filter (basic or flodata)"},
                 },
                 RPCResult{
                     RPCResult::Type::OBJ, "", "",
@@ -2519,6 +2648,188 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+static RPCHelpMan searchflodata()
+{
+    return RPCHelpMan{"searchflodata",
+                "\nFind the transactions in the active chain whose floData starts with a prefix, or has a SHA256 hash.\n"
+                "Requires -flodataindex.\n",
+                {
+                    {"query", RPCArg::Type::STR, RPCArg::Optional::NO, strprintf("The floData prefix to search for, at most %u bytes, or the hex SHA256 hash of the whole floData if by is \"hash\"", FLODATA_INDEX_PREFIX_SIZE)},
+                    {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The lowest block height to search"},
+                    {"end_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the chain tip height"}, "The highest block height to search"},
+                    {"count", RPCArg::Type::NUM, RPCArg::DefaultHint{"no limit"}, "The maximum number of transactions to return"},
+                    {"by", RPCArg::Type::STR, RPCArg::Default{"prefix"}, "\"prefix\" or \"hash\""},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "matching transactions, ordered by floData then by height",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "the transaction id"},
+                            {RPCResult::Type::NUM, "height", "the height of the block containing the transaction"},
+                            {RPCResult::Type::STR_HEX, "blockhash", "the hash of the block containing the transaction"},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("searchflodata", "\"text:\" 1000 2000 10")
+            + HelpExampleCli("searchflodata", "\"1fd8d4ff1b6d3f1b41ad76d7a06b6c4e4e51f0c32ba22b94c3fb7ee2a1d8e0a7\" 0 2000 10 hash")
+            + HelpExampleRpc("searchflodata", "\"text:\", 1000, 2000, 10")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_flodataindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires flodataindex to be enabled (-flodataindex)");
+    }
+
+    const std::string by = request.params[4].isNull() ? "prefix" : request.params[4].get_str();
+    if (by != "prefix" && by != "hash") {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "by must be \"prefix\" or \"hash\"");
+    }
+    const std::string query = request.params[0].get_str();
+    uint256 flo_data_hash;
+    if (by == "hash") {
+        flo_data_hash = ParseHashV(request.params[0], "query");
+    } else if (query.size() > FLODATA_INDEX_PREFIX_SIZE) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("prefix must be at most %u bytes", FLODATA_INDEX_PREFIX_SIZE));
+    }
+    const int start_height = request.params[1].isNull() ? 0 : request.params[1].get_int();
+    int end_height;
+    {
+        ChainstateManager& chainman = EnsureAnyChainman(request.context);
+        LOCK(cs_main);
+        end_height = request.params[2].isNull() ? chainman.ActiveChain().Height() : request.params[2].get_int();
+    }
+    if (start_height < 0 || end_height < start_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid height range");
+    }
+    size_t count = std::numeric_limits<size_t>::max();
+    if (!request.params[3].isNull()) {
+        if (request.params[3].get_int() < 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+        }
+        count = request.params[3].get_int();
+    }
+
+    if (!g_flodataindex->BlockUntilSyncedToCurrentChain() && g_flodataindex->GetSummary().best_block_height < end_height) {
+        throw JSONRPCError(RPC_MISC_ERROR, "floData index is still in the process of being built, try again later.");
+    }
+
+    std::vector<FloDataIndexEntry> entries;
+    const bool found = by == "hash" ? g_flodataindex->FindByHash(flo_data_hash, start_height, end_height, count, entries)
+                                    : g_flodataindex->FindByPrefix(query, start_height, end_height, count, entries);
+    if (!found) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read the floData index");
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const FloDataIndexEntry& entry : entries) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.txid.GetHex());
+        obj.pushKV("height", entry.height);
+        obj.pushKV("blockhash", entry.block_hash.GetHex());
+        ret.push_back(obj);
+    }
+    return ret;
+},
+    };
+}
+
+static RPCHelpMan dumpflodata()
+{
+    return RPCHelpMan{"dumpflodata",
+                "\nWrite the txid, height and floData of every transaction carrying floData in the active chain to a file.\n"
+                "Blocks are read directly from the block files, several files in parallel. Records are ordered by\n"
+                "position in the block files, which is not the height order for blocks that were downloaded out of order.\n",
+                {
+                    {"path", RPCArg::Type::STR, RPCArg::Optional::NO, "path to the output file. If relative, will be prefixed by datadir."},
+                    {"format", RPCArg::Type::STR, RPCArg::Default{"binary"}, "\"binary\": txid (32 bytes), height (4 bytes LE) and the CompactSize-prefixed floData per record.\n"
+                        "\"ndjson\": one {\"txid\",\"height\",\"floData\"} JSON object per line."},
+                    {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The lowest block height to export"},
+                    {"threads", RPCArg::Type::NUM, RPCArg::DefaultHint{"the number of cores"}, "The number of block files to read in parallel"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "blocks", "the number of blocks read"},
+                        {RPCResult::Type::NUM, "transactions", "the number of records written"},
+                        {RPCResult::Type::STR_HEX, "base_hash", "the hash of the highest exported block"},
+                        {RPCResult::Type::NUM, "base_height", "the height of the highest exported block"},
+                        {RPCResult::Type::STR, "path", "the absolute path that the records were written to"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("dumpflodata", "flodata.ndjson ndjson")
+            + HelpExampleRpc("dumpflodata", "\"flodata.ndjson\", \"ndjson\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const fs::path path = fsbridge::AbsPathJoin(gArgs.GetDataDirNet(), request.params[0].get_str());
+    // Write to a temporary path and then move into `path` on completion.
+    const fs::path temppath = fsbridge::AbsPathJoin(gArgs.GetDataDirNet(), request.params[0].get_str() + ".incomplete");
+
+    FloDataExportFormat format;
+    const std::string format_str = request.params[1].isNull() ? "binary" : request.params[1].get_str();
+    if (format_str == "binary") {
+        format = FloDataExportFormat::BINARY;
+    } else if (format_str == "ndjson") {
+        format = FloDataExportFormat::NDJSON;
+    } else {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown format: " + format_str);
+    }
+    const int start_height = request.params[2].isNull() ? 0 : request.params[2].get_int();
+    if (start_height < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid start_height");
+    }
+    int threads = request.params[3].isNull() ? 0 : request.params[3].get_int();
+    if (threads <= 0) threads = GetNumCores();
+
+    if (fs::exists(path)) {
+        throw JSONRPCError(
+            RPC_INVALID_PARAMETER,
+            path.string() + " already exists. If you are sure this is what you want, "
+            "move it out of the way first");
+    }
+
+    std::vector<FloDataExportBlock> blocks;
+    const CBlockIndex* tip;
+    {
+        ChainstateManager& chainman = EnsureAnyChainman(request.context);
+        LOCK(cs_main);
+        const CChain& active_chain = chainman.ActiveChain();
+        tip = active_chain.Tip();
+        for (int height = start_height; height <= active_chain.Height(); ++height) {
+            const CBlockIndex* pindex = active_chain[height];
+            if (!(pindex->nStatus & BLOCK_HAVE_DATA)) {
+                throw JSONRPCError(RPC_MISC_ERROR, strprintf("Block at height %d not available (pruned data)", height));
+            }
+            blocks.push_back({pindex, pindex->GetBlockPos()});
+        }
+    }
+
+    FloDataExportStats stats;
+    {
+        CAutoFile afile{fsbridge::fopen(temppath, "wb"), SER_DISK, CLIENT_VERSION};
+        if (afile.IsNull()) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Unable to open " + temppath.string());
+        }
+        if (!ExportFloData(blocks, format, threads, afile.Get(), stats, [] { return ShutdownRequested(); })) {
+            afile.fclose();
+            fs::remove(temppath);
+            throw JSONRPCError(RPC_MISC_ERROR, "Unable to export floData");
+        }
+    }
+    fs::rename(temppath, path);
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("blocks", stats.blocks);
+    result.pushKV("transactions", stats.transactions);
+    result.pushKV("base_hash", tip->GetBlockHash().GetHex());
+    result.pushKV("base_height", tip->nHeight);
+    result.pushKV("path", path.string());
+    return result;
+},
+    };
+}
+
 /**
  * Serialize the UTXO set to a file for loading elsewhere.
  *
@@ -2658,6 +2969,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         &getrawmempool,                      },
     { "blockchain",         &gettxout,                           },
     { "blockchain",         &gettxoutsetinfo,                    },
+    { "blockchain",         &getcoinscacheinfo,                  },
     { "blockchain",         &pruneblockchain,                    },
     { "blockchain",         &savemempool,                        },
     { "blockchain",         &verifychain,                        },
@@ -2665,6 +2977,8 @@ static const CRPCCommand commands[] =
     { "blockchain",         &preciousblock,                      },
     { "blockchain",         &scantxoutset,                       },
     { "blockchain",         &getblockfilter,                     },
+    { "blockchain",         &searchflodata,                      },
+    { "blockchain",         &dumpflodata,                        },
 
     /* Not shown in help */
     { "hidden",              &invalidateblock,                   },
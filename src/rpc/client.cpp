@@ -78,6 +78,11 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "sendmany", 9, "verbose" },
     { "deriveaddresses", 1, "range" },
     { "scantxoutset", 1, "scanobjects" },
+    { "searchflodata", 1, "start_height" },
+    { "searchflodata", 2, "end_height" },
+    { "searchflodata", 3, "count" },
+    { "dumpflodata", 2, "start_height" },
+    { "dumpflodata", 3, "threads" },
     { "addmultisigaddress", 0, "nrequired" },
     { "addmultisigaddress", 1, "keys" },
     { "createmultisig", 0, "nrequired" },
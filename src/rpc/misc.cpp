@@ -3,9 +3,11 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crypto/scrypt.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/flodataindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
@@ -737,6 +739,10 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_flodataindex) {
+        result.pushKVs(SummaryToJSON(g_flodataindex->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
@@ -746,6 +752,41 @@ static RPCHelpMan getindexinfo()
     };
 }
 
+static RPCHelpMan getscryptinfo()
+{
+    return RPCHelpMan{"getscryptinfo",
+                "Returns the number of scrypt hashes computed by this process, per thread.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "total", "Total number of scrypt hashes computed"},
+                        {RPCResult::Type::OBJ_DYN, "threads", "Number of scrypt hashes computed per thread name, including threads which have exited",
+                        {
+                            {RPCResult::Type::NUM, "name", "Number of scrypt hashes computed by threads with this name"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getscryptinfo", "")
+            + HelpExampleRpc("getscryptinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    uint64_t total = 0;
+    UniValue threads(UniValue::VOBJ);
+    for (const auto& [name, hashes] : ScryptGetHashCounts()) {
+        threads.pushKV(name.empty() ? "unnamed" : name, hashes);
+        total += hashes;
+    }
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("total", total);
+    obj.pushKV("threads", threads);
+    return obj;
+},
+    };
+}
+
 void RegisterMiscRPCCommands(CRPCTable &t)
 {
 // clang-format off
@@ -753,6 +794,7 @@ static const CRPCCommand commands[] =
 { //  category              actor (function)
   //  --------------------- ------------------------
     { "control",            &getmemoryinfo,           },
+    { "control",            &getscryptinfo,           },
     { "control",            &logging,                 },
     { "util",               &validateaddress,         },
     { "util",               &createmultisig,          },
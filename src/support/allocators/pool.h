@@ -0,0 +1,196 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLOCOIN_SUPPORT_ALLOCATORS_POOL_H
+#define FLOCOIN_SUPPORT_ALLOCATORS_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Memory resource for the many small, equally sized allocations made by
+ * node-based containers such as std::unordered_map.
+ *
+ * Memory is taken from the system in chunks of a fixed size and carved into
+ * blocks whose size is a multiple of ELEM_ALIGN_BYTES. A freed block is put on
+ * a free list for its size and handed out again by the next allocation of that
+ * size; chunks are only returned to the system when the resource is destroyed.
+ * Allocations larger than MAX_BLOCK_SIZE_BYTES (like the bucket array of a
+ * hash map) or with a stricter alignment than ALIGN_BYTES go straight to
+ * ::operator new.
+ *
+ * Compared to one malloc per node this saves the allocator's per-allocation
+ * overhead, keeps nodes packed together, and makes the memory used exactly
+ * known: it is the number of chunks times the chunk size.
+ *
+ * The resource is not thread safe, like the containers it is used for.
+ */
+template <std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+class PoolResource final
+{
+    static_assert(ALIGN_BYTES > 0 && (ALIGN_BYTES & (ALIGN_BYTES - 1)) == 0, "ALIGN_BYTES must be a power of two");
+
+    /** Free blocks are linked through their own memory. */
+    struct ListNode {
+        ListNode* m_next;
+        explicit ListNode(ListNode* next) : m_next(next) {}
+    };
+
+    /** Blocks are handed out in multiples of this size, which is always big enough to hold a ListNode. */
+    static constexpr std::size_t ELEM_ALIGN_BYTES = std::max(alignof(ListNode), ALIGN_BYTES);
+    static_assert(sizeof(ListNode) <= ELEM_ALIGN_BYTES, "a ListNode must fit into a block");
+
+    const std::size_t m_chunk_size_bytes;
+
+    //! All chunks taken from the system, freed in the destructor.
+    std::vector<std::byte*> m_allocated_chunks;
+
+    //! Free lists, indexed by block size in units of ELEM_ALIGN_BYTES.
+    std::array<ListNode*, MAX_BLOCK_SIZE_BYTES / ELEM_ALIGN_BYTES + 1> m_free_lists{};
+
+    //! Not yet handed out memory of the most recent chunk.
+    std::byte* m_available_memory_it{nullptr};
+    std::byte* m_available_memory_end{nullptr};
+
+    /** Number of ELEM_ALIGN_BYTES units a block of the given size takes. Zero sized blocks take one unit. */
+    static constexpr std::size_t NumElemAlignBytes(std::size_t bytes)
+    {
+        return (bytes + ELEM_ALIGN_BYTES - 1) / ELEM_ALIGN_BYTES + (bytes == 0);
+    }
+
+    static constexpr bool IsFreeListUsable(std::size_t bytes, std::size_t alignment)
+    {
+        return alignment <= ELEM_ALIGN_BYTES && bytes <= MAX_BLOCK_SIZE_BYTES;
+    }
+
+    void PushFree(void* p, std::size_t num_alignments)
+    {
+        m_free_lists[num_alignments] = new (p) ListNode{m_free_lists[num_alignments]};
+    }
+
+    void AllocateChunk()
+    {
+        // The rest of the current chunk is smaller than the block requested,
+        // but may still serve smaller blocks later.
+        if (m_available_memory_it != m_available_memory_end) {
+            PushFree(m_available_memory_it, (m_available_memory_end - m_available_memory_it) / ELEM_ALIGN_BYTES);
+        }
+        void* storage = ::operator new (m_chunk_size_bytes, std::align_val_t{ELEM_ALIGN_BYTES});
+        m_available_memory_it = new (storage) std::byte[m_chunk_size_bytes];
+        m_available_memory_end = m_available_memory_it + m_chunk_size_bytes;
+        m_allocated_chunks.push_back(m_available_memory_it);
+    }
+
+public:
+    /** Construct a resource that takes memory from the system in chunks of chunk_size_bytes. */
+    explicit PoolResource(std::size_t chunk_size_bytes)
+        : m_chunk_size_bytes(NumElemAlignBytes(chunk_size_bytes) * ELEM_ALIGN_BYTES)
+    {
+        assert(m_chunk_size_bytes >= MAX_BLOCK_SIZE_BYTES);
+    }
+
+    /** Construct a resource with chunks of 256 KiB. */
+    PoolResource() : PoolResource(262144) {}
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource()
+    {
+        for (std::byte* chunk : m_allocated_chunks) {
+            ::operator delete (static_cast<void*>(chunk), std::align_val_t{ELEM_ALIGN_BYTES});
+        }
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!IsFreeListUsable(bytes, alignment)) {
+            return ::operator new (bytes, std::align_val_t{alignment});
+        }
+        const std::size_t num_alignments = NumElemAlignBytes(bytes);
+        if (ListNode* node = m_free_lists[num_alignments]) {
+            m_free_lists[num_alignments] = node->m_next;
+            node->~ListNode();
+            return node;
+        }
+        const std::size_t round_bytes = num_alignments * ELEM_ALIGN_BYTES;
+        if (round_bytes > static_cast<std::size_t>(m_available_memory_end - m_available_memory_it)) {
+            AllocateChunk();
+        }
+        return std::exchange(m_available_memory_it, m_available_memory_it + round_bytes);
+    }
+
+    void Deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (!IsFreeListUsable(bytes, alignment)) {
+            ::operator delete (p, std::align_val_t{alignment});
+            return;
+        }
+        PushFree(p, NumElemAlignBytes(bytes));
+    }
+
+    std::size_t NumAllocatedChunks() const { return m_allocated_chunks.size(); }
+    std::size_t ChunkSizeBytes() const { return m_chunk_size_bytes; }
+};
+
+/**
+ * Allocator handing out memory from a PoolResource. The resource is not owned
+ * and must outlive every container using it.
+ */
+template <class T, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES = alignof(T)>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+    using ResourceType = PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>;
+
+    PoolAllocator(ResourceType* resource) noexcept : m_resource(resource) {}
+    PoolAllocator(const PoolAllocator& other) noexcept = default;
+    PoolAllocator& operator=(const PoolAllocator& other) noexcept = default;
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& other) noexcept : m_resource(other.resource()) {}
+
+    template <class U>
+    struct rebind {
+        using other = PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>;
+    };
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(m_resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        m_resource->Deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    ResourceType* resource() const noexcept { return m_resource; }
+
+private:
+    ResourceType* m_resource;
+};
+
+template <class T1, class T2, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+bool operator==(const PoolAllocator<T1, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& a,
+                const PoolAllocator<T2, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& b) noexcept
+{
+    return a.resource() == b.resource();
+}
+
+template <class T1, class T2, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+bool operator!=(const PoolAllocator<T1, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& a,
+                const PoolAllocator<T2, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& b) noexcept
+{
+    return !(a == b);
+}
+
+#endif // FLOCOIN_SUPPORT_ALLOCATORS_POOL_H
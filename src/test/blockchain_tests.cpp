@@ -7,7 +7,9 @@
 #include <stdlib.h>
 
 #include <chain.h>
+#include <clientversion.h>
 #include <rpc/blockchain.h>
+#include <streams.h>
 #include <test/util/setup_common.h>
 #include <util/string.h>
 
@@ -74,4 +76,85 @@ BOOST_AUTO_TEST_CASE(get_difficulty_for_very_high_target)
     TestDifficulty(0x12345678, 5913134931067755359633408.0);
 }
 
+/** A block index record as serialized by clients that don't know hashPoW. */
+struct OldDiskBlockIndex : public CDiskBlockIndex {
+    SERIALIZE_METHODS(OldDiskBlockIndex, obj)
+    {
+        int _nVersion = s.GetVersion();
+        READWRITE(VARINT_MODE(_nVersion, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(VARINT_MODE(obj.nHeight, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(VARINT(obj.nStatus));
+        READWRITE(VARINT(obj.nTx));
+        if (obj.nStatus & (BLOCK_HAVE_DATA | BLOCK_HAVE_UNDO)) READWRITE(VARINT_MODE(obj.nFile, VarIntMode::NONNEGATIVE_SIGNED));
+        if (obj.nStatus & BLOCK_HAVE_DATA) READWRITE(VARINT(obj.nDataPos));
+        if (obj.nStatus & BLOCK_HAVE_UNDO) READWRITE(VARINT(obj.nUndoPos));
+        READWRITE(obj.nVersion, obj.hashPrev, obj.hashMerkleRoot, obj.nTime, obj.nBits, obj.nNonce);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(disk_block_index_pow_hash)
+{
+    CBlockIndex index;
+    index.nHeight = 100;
+    index.nBits = 0x1e0ffff0;
+    index.nNonce = 12345;
+    index.nStatus = BLOCK_HAVE_DATA;
+    index.nDataPos = 80;
+    index.SetBlockPoWHash(InsecureRand256());
+
+    // The hash survives a round trip through the current record version.
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << CDiskBlockIndex(&index);
+    CDiskBlockIndex read;
+    ss >> read;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(read.nStatus & BLOCK_HAVE_POW_HASH);
+    BOOST_CHECK_EQUAL(read.hashPoW, index.hashPoW);
+    BOOST_CHECK_EQUAL(read.GetBlockPoWHash(), index.hashPoW);
+
+    // Records are stamped with a version that knows the hash, even when
+    // written by a client that claims an older one.
+    CDataStream low_ss(SER_DISK, DISK_BLOCK_INDEX_POW_HASH_VERSION - 1);
+    low_ss << CDiskBlockIndex(&index);
+    CDiskBlockIndex low_read;
+    low_ss >> low_read;
+    BOOST_CHECK(low_ss.empty());
+    BOOST_CHECK_EQUAL(low_read.hashPoW, index.hashPoW);
+
+    // Downgrade: a client that doesn't know the hash reads the record,
+    // ignoring the hash but keeping the status bit, and rewrites it
+    // stamped with its own version, which is the version before the hash.
+    for (const int old_version : {DISK_BLOCK_INDEX_POW_HASH_VERSION - 1, 220000}) {
+        CDataStream new_record(SER_DISK, CLIENT_VERSION);
+        new_record << CDiskBlockIndex(&index);
+        new_record.SetVersion(old_version);
+        OldDiskBlockIndex old_index;
+        new_record >> old_index;
+        BOOST_CHECK(old_index.nStatus & BLOCK_HAVE_POW_HASH);
+        CDataStream old_record(SER_DISK, old_version);
+        old_record << old_index;
+
+        // Upgrade: the record is read back in full, without the hash.
+        CDiskBlockIndex upgraded;
+        old_record >> upgraded;
+        BOOST_CHECK(old_record.empty());
+        BOOST_CHECK(!(upgraded.nStatus & BLOCK_HAVE_POW_HASH));
+        BOOST_CHECK(upgraded.nStatus & BLOCK_HAVE_DATA);
+        BOOST_CHECK(upgraded.hashPoW.IsNull());
+        BOOST_CHECK_EQUAL(upgraded.nHeight, index.nHeight);
+        BOOST_CHECK_EQUAL(upgraded.nDataPos, index.nDataPos);
+        BOOST_CHECK_EQUAL(upgraded.nNonce, index.nNonce);
+        BOOST_CHECK_EQUAL(upgraded.GetBlockHash(), CDiskBlockIndex(&index).GetBlockHash());
+
+        // Once the hash is set again, it is written and read as before.
+        upgraded.SetBlockPoWHash(index.hashPoW);
+        CDataStream rewritten(SER_DISK, CLIENT_VERSION);
+        rewritten << upgraded;
+        CDiskBlockIndex reread;
+        rewritten >> reread;
+        BOOST_CHECK(rewritten.empty());
+        BOOST_CHECK_EQUAL(reread.GetBlockPoWHash(), index.hashPoW);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <fs.h>
+#include <node/blockfilemap.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <string>
+
+BOOST_FIXTURE_TEST_SUITE(blockfilemap_tests, BasicTestingSetup)
+
+static fs::path WriteFile(const fs::path& path, const std::string& content)
+{
+    FILE* file = fsbridge::fopen(path, "wb");
+    BOOST_REQUIRE(file);
+    BOOST_REQUIRE_EQUAL(fwrite(content.data(), 1, content.size(), file), content.size());
+    fclose(file);
+    return path;
+}
+
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(mapped_file_cache)
+{
+    const fs::path dir = m_args.GetDataDirBase();
+    const fs::path path0 = WriteFile(dir / "map0.dat", "abcdef");
+    const fs::path path1 = WriteFile(dir / "map1.dat", "ghijkl");
+    const fs::path path2 = WriteFile(dir / "map2.dat", "mnopqr");
+
+    MappedFileCache cache(2);
+    std::shared_ptr<const MappedFile> map0 = cache.Get(0, path0, 1, 4);
+    BOOST_REQUIRE(map0);
+    BOOST_CHECK_EQUAL(std::string(map0->data().begin(), map0->data().end()), "abcd");
+
+    // A cached mapping that is large enough is reused.
+    BOOST_CHECK(cache.Get(0, path0, 4, 6) == map0);
+    // One that is too small is replaced by a mapping of the new size.
+    std::shared_ptr<const MappedFile> map0_grown = cache.Get(0, path0, 5, 6);
+    BOOST_REQUIRE(map0_grown);
+    BOOST_CHECK(map0_grown != map0);
+    BOOST_CHECK_EQUAL(map0_grown->data().size(), 6U);
+    // The replaced mapping stays readable while it is in use.
+    BOOST_CHECK_EQUAL(map0->data()[3], 'd');
+
+    // The least recently used mapping is evicted.
+    std::shared_ptr<const MappedFile> map1 = cache.Get(1, path1, 1, 6);
+    BOOST_CHECK(cache.Get(0, path0, 1, 6) == map0_grown);
+    BOOST_REQUIRE(cache.Get(2, path2, 1, 6));
+    BOOST_CHECK(cache.Get(0, path0, 1, 6) == map0_grown);
+    BOOST_CHECK(cache.Get(1, path1, 1, 6) != map1);
+
+    cache.Erase(0);
+    BOOST_CHECK(cache.Get(0, path0, 1, 6) != map0_grown);
+
+    // Files that do not exist, or requests beyond the size to map, are not mapped.
+    BOOST_CHECK(!cache.Get(3, dir / "missing.dat", 1, 6));
+    BOOST_CHECK(!cache.Get(4, path0, 7, 6));
+
+    cache.SetMaxMappings(0);
+    BOOST_CHECK(!cache.Get(0, path0, 1, 6));
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -125,6 +125,50 @@ BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
     BOOST_CHECK(default_ctor_block_filter_1.GetEncodedFilter() == default_ctor_block_filter_2.GetEncodedFilter());
 }
 
+BOOST_AUTO_TEST_CASE(blockfilter_flodata_test)
+{
+    CMutableTransaction tx_1;
+    tx_1.vout.emplace_back(100, CScript() << OP_TRUE);
+    tx_1.strFloData = "text:hello world";
+
+    CMutableTransaction tx_2;
+    tx_2.vout.emplace_back(200, CScript() << OP_TRUE);
+    tx_2.strFloData = "FLO-RMT:asset:" + std::string(FLODATA_FILTER_PREFIX_SIZE, 'x') + ":late:";
+
+    CMutableTransaction tx_3;
+    tx_3.vout.emplace_back(300, CScript() << OP_TRUE);
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(tx_1));
+    block.vtx.push_back(MakeTransactionRef(tx_2));
+    block.vtx.push_back(MakeTransactionRef(tx_3));
+
+    BlockFilter block_filter(BlockFilterType::FLODATA, block, CBlockUndo());
+    const GCSFilter& filter = block_filter.GetFilter();
+
+    auto element = [](const std::string& str) { return GCSFilter::Element(str.begin(), str.end()); };
+    BOOST_CHECK(filter.Match(element("text:")));
+    BOOST_CHECK(filter.Match(element("text:hello world")));
+    BOOST_CHECK(filter.Match(element("FLO-RMT:")));
+    BOOST_CHECK(filter.Match(element("FLO-RMT:asset:")));
+    BOOST_CHECK(filter.Match(element(tx_2.strFloData.str().substr(0, FLODATA_FILTER_PREFIX_SIZE))));
+
+    // Separators past the prefix size, partial tokens and scripts are not included.
+    BOOST_CHECK(!filter.Match(element(tx_2.strFloData.str().substr(0, tx_2.strFloData.str().find(":late:") + 1))));
+    BOOST_CHECK(!filter.Match(element("text")));
+    BOOST_CHECK(!filter.Match(element("other:")));
+    const CScript script = CScript() << OP_TRUE;
+    BOOST_CHECK(!filter.Match(GCSFilter::Element(script.begin(), script.end())));
+
+    // Test serialization/unserialization.
+    BlockFilter block_filter2;
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << block_filter;
+    stream >> block_filter2;
+    BOOST_CHECK_EQUAL(block_filter2.GetFilterType(), BlockFilterType::FLODATA);
+    BOOST_CHECK(block_filter.GetEncodedFilter() == block_filter2.GetEncodedFilter());
+}
+
 BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 {
     UniValue json;
@@ -187,6 +231,9 @@ BOOST_AUTO_TEST_CASE(blockfilter_type_names)
     BlockFilterType filter_type;
     BOOST_CHECK(BlockFilterTypeByName("basic", filter_type));
     BOOST_CHECK_EQUAL(filter_type, BlockFilterType::BASIC);
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::FLODATA), "flodata");
+    BOOST_CHECK(BlockFilterTypeByName("flodata", filter_type));
+    BOOST_CHECK_EQUAL(filter_type, BlockFilterType::FLODATA);
 
     BOOST_CHECK(!BlockFilterTypeByName("unknown", filter_type));
 }
@@ -0,0 +1,142 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <miner.h>
+#include <node/blockprefetcher.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+
+/** A short regtest chain of blocks mined for their scrypt hash, which CheckBlock() verifies. */
+struct PrefetchTestingSetup : public RegTestingSetup {
+    PrefetchTestingSetup()
+    {
+        ChainstateManager& chainman = *Assert(m_node.chainman);
+        for (int i = 0; i < 20; ++i) {
+            CTxMemPool empty_pool;
+            CBlock block = BlockAssembler(chainman.ActiveChainstate(), empty_pool, Params()).CreateNewBlock(CScript() << OP_TRUE)->block;
+            block.hashMerkleRoot = BlockMerkleRoot(block);
+            while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, Params().GetConsensus())) ++block.nNonce;
+            Assert(chainman.ProcessNewBlock(Params(), std::make_shared<const CBlock>(block), true, nullptr));
+        }
+        const int height = WITH_LOCK(cs_main, return chainman.ActiveChain().Height());
+        Assert(height == 20);
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(blockprefetcher_tests)
+
+BOOST_FIXTURE_TEST_CASE(blockprefetcher_get, PrefetchTestingSetup)
+{
+    std::vector<BlockPrefetcher::BlockRef> blocks;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain = m_node.chainman->ActiveChain();
+        for (int height = 1; height <= active_chain.Height(); ++height) {
+            blocks.emplace_back(active_chain[height]->GetBlockHash(), active_chain[height]->GetBlockPos());
+        }
+    }
+
+    // Boost.Test assertions are not thread-safe, so the workers only record
+    // their results, and the main thread checks them.
+    std::atomic<int> prepared{0};
+    std::atomic<int> checked{0};
+    BlockPrefetcher prefetcher(Params().GetConsensus(), 3, [&](const CBlock& block) {
+        BlockValidationState state;
+        if (CheckBlock(block, state, Params().GetConsensus())) ++checked;
+        ++prepared;
+    });
+    const auto wait_prepared = [&](int count) {
+        for (int n = 0; n < 10000 && prepared < count; ++n) {
+            UninterruptibleSleep(std::chrono::milliseconds{1});
+        }
+        BOOST_REQUIRE_EQUAL(prepared.load(), count);
+    };
+
+    // Blocks that were never requested are not returned.
+    BOOST_CHECK(!prefetcher.Get(blocks[0].first));
+
+    // Get() cancels reads that have not started, so wait for all of them.
+    prefetcher.Prefetch(blocks);
+    wait_prepared(int(blocks.size()));
+    for (const auto& [hash, pos] : blocks) {
+        std::shared_ptr<const CBlock> block = prefetcher.Get(hash);
+        BOOST_REQUIRE(block);
+        BOOST_CHECK(block->GetHash() == hash);
+        BOOST_CHECK(block->fChecked);
+    }
+    BOOST_CHECK_EQUAL(checked.load(), int(blocks.size()));
+
+    // A block is handed out only once.
+    BOOST_CHECK(!prefetcher.Get(blocks.back().first));
+
+    // A block at the wrong position fails its hash check, is not prepared and
+    // is reported missing. The queue is read in order, so once the block
+    // after it was prepared its read has started.
+    prefetcher.Prefetch({{blocks[0].first, blocks[1].second}, blocks[2]});
+    wait_prepared(int(blocks.size()) + 1);
+    BOOST_CHECK(!prefetcher.Get(blocks[0].first));
+    BOOST_CHECK(prefetcher.Get(blocks[2].first));
+    BOOST_CHECK_EQUAL(prepared.load(), int(blocks.size()) + 1);
+    BOOST_CHECK_EQUAL(checked.load(), int(blocks.size()) + 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockprefetcher_chain, PrefetchTestingSetup)
+{
+    BlockPrefetcher prefetcher(Params().GetConsensus(), 2);
+    std::vector<const CBlockIndex*> block_indexes;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain = m_node.chainman->ActiveChain();
+        for (int height = 10; height <= active_chain.Height(); ++height) {
+            block_indexes.push_back(active_chain[height]);
+        }
+    }
+
+    // Scan the end of the chain the way index syncs do, prefetching a window
+    // of 4 blocks from each block on. Past the tip the window shrinks.
+    for (const CBlockIndex* pindex : block_indexes) {
+        WITH_LOCK(cs_main, prefetcher.Prefetch(m_node.chainman->ActiveChain(), pindex, 4));
+        std::shared_ptr<const CBlock> block = prefetcher.Get(pindex->GetBlockHash());
+        if (block) BOOST_CHECK(block->GetHash() == pindex->GetBlockHash());
+    }
+
+    // Blocks that are not on the chain are not prefetched.
+    CBlockIndex orphan;
+    WITH_LOCK(cs_main, prefetcher.Prefetch(m_node.chainman->ActiveChain(), &orphan, 4));
+    BOOST_CHECK(!prefetcher.Get(block_indexes.back()->GetBlockHash()));
+}
+
+BOOST_FIXTURE_TEST_CASE(blockprefetcher_connect, PrefetchTestingSetup)
+{
+    // Connect the whole chain again in one go, with prefetch windows shorter
+    // and longer than the chain, and without prefetching.
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    CBlockIndex* tip = WITH_LOCK(cs_main, return chainman.ActiveChain().Tip());
+    CBlockIndex* first = WITH_LOCK(cs_main, return chainman.ActiveChain()[1]);
+    const int block_prefetch = g_block_prefetch;
+    for (const int window : {4, 32, 0}) {
+        g_block_prefetch = window;
+        BlockValidationState state;
+        BOOST_REQUIRE(chainman.ActiveChainstate().InvalidateBlock(state, first));
+        BOOST_CHECK_EQUAL(WITH_LOCK(cs_main, return chainman.ActiveChain().Height()), 0);
+        WITH_LOCK(cs_main, chainman.ActiveChainstate().ResetBlockFailureFlags(first));
+        BOOST_REQUIRE(chainman.ActiveChainstate().ActivateBestChain(state));
+        BOOST_CHECK(state.IsValid());
+        BOOST_CHECK(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()) == tip);
+    }
+    g_block_prefetch = block_prefetch;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -201,6 +201,38 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_Random)
     Correct_Queue_range(range);
 }
 
+/** Test that checks are all run once with more workers than the old 15 thread
+ * limit, so most of them have to steal their work.
+ */
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_ManyThreads)
+{
+    auto queue = std::make_unique<Unique_Queue>(QUEUE_BATCH_SIZE);
+    queue->StartWorkerThreads(64);
+    WITH_LOCK(UniqueCheck::m, UniqueCheck::results.clear());
+
+    size_t COUNT = 10000;
+    size_t total = COUNT;
+    {
+        CCheckQueueControl<UniqueCheck> control(queue.get());
+        while (total) {
+            size_t r = InsecureRandRange(10);
+            std::vector<UniqueCheck> vChecks;
+            for (size_t k = 0; k < r && total; k++)
+                vChecks.emplace_back(--total);
+            control.Add(vChecks);
+        }
+        BOOST_REQUIRE(control.Wait());
+    }
+    {
+        LOCK(UniqueCheck::m);
+        BOOST_REQUIRE_EQUAL(UniqueCheck::results.size(), COUNT);
+        for (size_t i = 0; i < COUNT; ++i) {
+            BOOST_REQUIRE_EQUAL(UniqueCheck::results.count(i), 1U);
+        }
+        UniqueCheck::results.clear();
+    }
+    queue->StopWorkerThreads();
+}
 
 /** Test that failing checks are caught */
 BOOST_AUTO_TEST_CASE(test_CheckQueue_Catches_Failure)
@@ -0,0 +1,114 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <node/coinprefetcher.h>
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(coinprefetcher_tests, BasicTestingSetup)
+
+static Coin MakeCoin(CAmount value)
+{
+    return Coin{CTxOut{value, GetScriptForDestination(PKHash{})}, /*nHeight*/ 1, /*fCoinBase*/ false};
+}
+
+/** A block spending the given outpoints, an output of its own and a missing coin. */
+static CBlock MakeBlock(const std::vector<COutPoint>& outpoints)
+{
+    CBlock block;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(50 * COIN, CScript{} << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    CMutableTransaction tx;
+    for (const COutPoint& outpoint : outpoints) {
+        tx.vin.emplace_back(outpoint);
+    }
+    tx.vin.emplace_back(COutPoint{InsecureRand256(), 0});
+    tx.vout.emplace_back(COIN, CScript{} << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(tx));
+
+    CMutableTransaction child;
+    child.vin.emplace_back(block.vtx.back()->GetHash(), 0);
+    child.vout.emplace_back(COIN, CScript{} << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(child));
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(coinprefetcher_warm_cache)
+{
+    CCoinsViewDB db{"test_prefetch", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false};
+    std::vector<COutPoint> outpoints;
+    {
+        CCoinsViewCache cache{&db};
+        cache.SetBestBlock(InsecureRand256());
+        for (uint32_t n = 0; n < 40; ++n) {
+            outpoints.emplace_back(InsecureRand256(), n);
+            cache.AddCoin(outpoints.back(), MakeCoin(n + 1), /*possible_overwrite*/ false);
+        }
+        BOOST_CHECK(cache.Flush());
+    }
+    const CBlock block = MakeBlock(outpoints);
+    CoinPrefetcher prefetcher{db, /*threads*/ 2};
+
+    // Coins read ahead of time are added to the cache.
+    prefetcher.PrefetchBlock(block);
+    {
+        LOCK(cs_main);
+        CCoinsViewCache cache{&db};
+        prefetcher.WarmCache(block, cache);
+        BOOST_CHECK_EQUAL(cache.GetCacheSize(), outpoints.size());
+        for (uint32_t n = 0; n < outpoints.size(); ++n) {
+            BOOST_CHECK(cache.HaveCoinInCache(outpoints[n]));
+            BOOST_CHECK_EQUAL(cache.AccessCoin(outpoints[n]).out.nValue, CAmount(n + 1));
+        }
+        BOOST_CHECK(!cache.HaveCoinInCache(block.vtx[2]->vin[0].prevout));
+        // The lookups the prefetch saved are counted separately.
+        BOOST_CHECK_EQUAL(cache.GetStats().warmed, outpoints.size());
+        BOOST_CHECK_EQUAL(cache.GetStats().misses, 0U);
+    }
+
+    // After the database was written the prefetched coins are not trusted,
+    // and the coins are read again.
+    prefetcher.PrefetchBlock(block);
+    {
+        CCoinsViewCache cache{&db};
+        BOOST_CHECK(cache.SpendCoin(outpoints[0]));
+        cache.SetBestBlock(InsecureRand256());
+        BOOST_CHECK(cache.Flush());
+    }
+    {
+        LOCK(cs_main);
+        CCoinsViewCache cache{&db};
+        prefetcher.WarmCache(block, cache);
+        BOOST_CHECK_EQUAL(cache.GetCacheSize(), outpoints.size() - 1);
+        BOOST_CHECK_EQUAL(cache.GetStats().warmed, outpoints.size() - 1);
+        BOOST_CHECK(!cache.HaveCoinInCache(outpoints[0]));
+        for (uint32_t n = 1; n < outpoints.size(); ++n) {
+            BOOST_CHECK_EQUAL(cache.AccessCoin(outpoints[n]).out.nValue, CAmount(n + 1));
+        }
+    }
+
+    // Coins the cache already has are not replaced.
+    prefetcher.PrefetchBlock(block);
+    {
+        LOCK(cs_main);
+        CCoinsViewCache cache{&db};
+        cache.AddCoin(outpoints[1], MakeCoin(1000), /*possible_overwrite*/ true);
+        prefetcher.WarmCache(block, cache);
+        BOOST_CHECK_EQUAL(cache.AccessCoin(outpoints[1]).out.nValue, 1000);
+        BOOST_CHECK_EQUAL(cache.AccessCoin(outpoints[2]).out.nValue, 3);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
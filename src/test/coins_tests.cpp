@@ -6,6 +6,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <script/standard.h>
+#include <shutdown.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
 #include <txdb.h>
@@ -271,6 +272,142 @@ BOOST_AUTO_TEST_CASE(coins_cache_simulation_test)
 
     CCoinsViewDB db_base{"test", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false};
     SimulationTest(&db_base, true);
+
+    CCoinsViewDB background_db_base{"test_background", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false, /*background_flush*/ true};
+    SimulationTest(&background_db_base, true);
+    BOOST_CHECK(background_db_base.Sync());
+}
+
+BOOST_AUTO_TEST_CASE(coins_background_flush)
+{
+    CCoinsViewDB db{"test_background", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false, /*background_flush*/ true};
+    std::vector<COutPoint> outpoints;
+    for (int flush = 0; flush < 10; ++flush) {
+        CCoinsViewCache cache{&db};
+        // Spend the coins of the previous round and add new ones.
+        for (const COutPoint& outpoint : outpoints) {
+            BOOST_CHECK(cache.SpendCoin(outpoint));
+        }
+        outpoints.clear();
+        for (int i = 0; i < 1000; ++i) {
+            Coin coin;
+            coin.out.nValue = InsecureRand32();
+            coin.nHeight = flush + 1;
+            outpoints.emplace_back(InsecureRand256(), 0);
+            cache.AddCoin(outpoints.back(), std::move(coin), /*possible_overwrite*/ false);
+        }
+        const uint256 best_block = InsecureRand256();
+        cache.SetBestBlock(best_block);
+        BOOST_CHECK(cache.Flush());
+
+        // Whether or not the batch has been written yet, the database view
+        // reflects it.
+        BOOST_CHECK(db.GetBestBlock() == best_block);
+        for (const COutPoint& outpoint : outpoints) {
+            Coin coin;
+            BOOST_CHECK(db.GetCoin(outpoint, coin));
+            BOOST_CHECK_EQUAL(coin.nHeight, uint32_t(flush + 1));
+        }
+    }
+    BOOST_CHECK(db.Sync());
+    BOOST_CHECK(db.GetHeadBlocks().empty());
+
+    size_t count = 0;
+    for (auto cursor = db.Cursor(); cursor->Valid(); cursor->Next()) {
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(count, outpoints.size());
+}
+
+BOOST_AUTO_TEST_CASE(coins_background_flush_failure)
+{
+    CCoinsViewDB db{"test_background", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false, /*background_flush*/ true};
+    const COutPoint outpoint{InsecureRand256(), 0};
+    const uint256 best_block = InsecureRand256();
+    // The failure shuts the node down, which needs the shutdown state.
+    BOOST_REQUIRE(InitShutdownState());
+    db.SimulateWriteFailure();
+    {
+        CCoinsViewCache cache{&db};
+        Coin coin;
+        coin.out.nValue = InsecureRand32();
+        coin.nHeight = 1;
+        cache.AddCoin(outpoint, std::move(coin), /*possible_overwrite*/ false);
+        cache.SetBestBlock(best_block);
+        BOOST_CHECK(cache.Flush());
+    }
+
+    // The failed write shuts the node down, and its coins stay readable.
+    BOOST_CHECK(!db.Sync());
+    BOOST_CHECK(ShutdownRequested());
+    AbortShutdown();
+    BOOST_CHECK(db.HaveCoin(outpoint));
+    BOOST_CHECK(db.GetBestBlock() == best_block);
+
+    // No further batches are accepted.
+    CCoinsViewCache cache{&db};
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    cache.SetBestBlock(InsecureRand256());
+    BOOST_CHECK(!cache.Flush());
+    BOOST_CHECK(db.HaveCoin(outpoint));
+}
+
+BOOST_AUTO_TEST_CASE(coins_partial_flush)
+{
+    CCoinsViewDB db{"test_partial", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false};
+    CCoinsViewCache cache{&db};
+
+    // Connect ten "blocks" of 100 coins each.
+    std::vector<std::vector<COutPoint>> blocks(10);
+    for (auto& block : blocks) {
+        CCoinsViewCache block_view{&cache};
+        for (int i = 0; i < 100; ++i) {
+            Coin coin;
+            coin.out.nValue = InsecureRand32();
+            coin.nHeight = 1;
+            block.emplace_back(InsecureRand256(), 0);
+            block_view.AddCoin(block.back(), std::move(coin), /*possible_overwrite*/ false);
+        }
+        block_view.SetBestBlock(InsecureRand256());
+        BOOST_CHECK(block_view.Flush());
+    }
+    // Use the coins of the second block again.
+    for (const COutPoint& outpoint : blocks[1]) {
+        BOOST_CHECK(cache.HaveCoin(outpoint));
+    }
+    BOOST_CHECK_EQUAL(cache.GetStats().hits, 100U);
+
+    // Room for the coins of three blocks: the two most recent ones, and the
+    // one used last.
+    const size_t entry_usage = sizeof(CCoinsMap::value_type) + sizeof(void*) * 3;
+    BOOST_CHECK(cache.PartialFlush(300 * entry_usage));
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 300U);
+    for (size_t n = 0; n < blocks.size(); ++n) {
+        const bool kept = n == 1 || n >= 8;
+        for (const COutPoint& outpoint : blocks[n]) {
+            BOOST_CHECK_EQUAL(cache.HaveCoinInCache(outpoint), kept);
+            Coin coin;
+            BOOST_CHECK(db.GetCoin(outpoint, coin));
+        }
+    }
+
+    const CCoinsCacheStats stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.flushes, 1U);
+    BOOST_CHECK_EQUAL(stats.coins_kept, 300U);
+    BOOST_CHECK_EQUAL(stats.hits_before_flush, 100U);
+    BOOST_CHECK_EQUAL(stats.hits, 0U);
+
+    // The coins kept are clean: spending one writes its spentness to the
+    // database on the next flush.
+    BOOST_CHECK(cache.SpendCoin(blocks[9][0]));
+    BOOST_CHECK(cache.HaveCoin(blocks[0][0]));
+    BOOST_CHECK_EQUAL(cache.GetStats().hits, 1U);
+    BOOST_CHECK_EQUAL(cache.GetStats().misses, 1U);
+    BOOST_CHECK(cache.Flush());
+    Coin coin;
+    BOOST_CHECK(!db.GetCoin(blocks[9][0], coin));
+    BOOST_CHECK(db.GetCoin(blocks[0][0], coin));
+    BOOST_CHECK_EQUAL(cache.GetStats().coins_kept, 0U);
 }
 
 // Store of all necessary tx and undo data for next test
@@ -609,7 +746,8 @@ void GetCoinsMapEntry(const CCoinsMap& map, CAmount& value, char& flags)
 
 void WriteCoinsViewEntry(CCoinsView& view, CAmount value, char flags)
 {
-    CCoinsMap map;
+    CCoinsMapMemoryResource resource;
+    CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
     InsertCoinsMapEntry(map, value, flags);
     BOOST_CHECK(view.BatchWrite(map, {}));
 }
@@ -10,6 +10,7 @@
 #include <crypto/hmac_sha512.h>
 #include <crypto/poly1305.h>
 #include <crypto/ripemd160.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha3.h>
@@ -20,6 +21,7 @@
 #include <test/util/setup_common.h>
 #include <util/strencodings.h>
 
+#include <thread>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -753,6 +755,43 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(scrypt_multi)
+{
+    for (int i = 0; i <= 40; ++i) {
+        char in[80 * 40];
+        char out1[32 * 40], out2[32 * 40];
+        for (int j = 0; j < 80 * i; ++j) {
+            in[j] = InsecureRandBits(8);
+        }
+        for (int j = 0; j < i; ++j) {
+            scrypt_1024_1_1_256(in + 80 * j, out1 + 32 * j);
+        }
+        scrypt_1024_1_1_256_multi(in, out2, i);
+        BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(scrypt_thread_state)
+{
+    // Boost.Test assertions are not thread safe, so only record results in the worker.
+    uintptr_t before{0}, after{0};
+    std::thread worker([&] {
+        ScryptSetThreadName("scrypt_test");
+        char in[80 * 20] = {};
+        char out[32 * 20];
+        scrypt_1024_1_1_256(in, out);
+        // The scratchpad outlives hashes of any width on the same thread.
+        before = (uintptr_t)ScryptThreadScratchpad();
+        scrypt_1024_1_1_256_multi(in, out, 20);
+        after = (uintptr_t)ScryptThreadScratchpad();
+    });
+    worker.join();
+    BOOST_CHECK_EQUAL(before % 64, 0U);
+    BOOST_CHECK_EQUAL(after, before);
+    // Counts of exited threads are kept.
+    BOOST_CHECK_EQUAL(ScryptGetHashCounts()["scrypt_test"], 21U);
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
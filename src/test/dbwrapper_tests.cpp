@@ -398,6 +398,56 @@ BOOST_AUTO_TEST_CASE(iterator_string_ordering)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_options)
+{
+    // Unset options leave the defaults.
+    DBOptions db_options = ReadDBOptions(m_args, "test");
+    BOOST_CHECK_EQUAL(db_options.write_buffer_size, 0U);
+    BOOST_CHECK_EQUAL(db_options.block_size, 0U);
+    BOOST_CHECK_EQUAL(db_options.bloom_bits, DBOptions{}.bloom_bits);
+    BOOST_CHECK(!db_options.compression);
+    BOOST_CHECK_EQUAL(db_options.max_file_size, 0U);
+
+    m_args.ForceSetArg("-testdbwritebuffer", "1");
+    m_args.ForceSetArg("-testdbblocksize", "16");
+    m_args.ForceSetArg("-testdbbloombits", "100");
+    m_args.ForceSetArg("-testdbcompression", "1");
+    m_args.ForceSetArg("-testdbfilesize", "-1");
+    db_options = ReadDBOptions(m_args, "test");
+    BOOST_CHECK_EQUAL(db_options.write_buffer_size, 1U << 20);
+    BOOST_CHECK_EQUAL(db_options.block_size, 16U << 10);
+    BOOST_CHECK_EQUAL(db_options.bloom_bits, MAX_DB_BLOOM_BITS);
+    BOOST_CHECK(db_options.compression);
+    BOOST_CHECK_EQUAL(db_options.max_file_size, 0U);
+
+    // Options of other databases are separate.
+    BOOST_CHECK_EQUAL(ReadDBOptions(m_args, "other").block_size, 0U);
+
+    // The tuning doesn't change what is stored, so a database can be
+    // reopened with a different one.
+    fs::path ph = m_args.GetDataDirBase() / "dbwrapper_options";
+    std::vector<std::pair<uint256, uint256>> entries;
+    for (int i = 0; i < 10000; ++i) {
+        entries.emplace_back(InsecureRand256(), InsecureRand256());
+    }
+    db_options.write_buffer_size = 64 << 10;
+    db_options.max_file_size = 64 << 10;
+    db_options.bloom_bits = 0;
+    {
+        CDBWrapper dbw(ph, 1 << 20, false, true, false, db_options);
+        for (const auto& [key, value] : entries) {
+            BOOST_CHECK(dbw.Write(key, value));
+        }
+    }
+    CDBWrapper dbw(ph, 1 << 20);
+    uint256 res;
+    for (const auto& [key, value] : entries) {
+        BOOST_CHECK(dbw.Read(key, res));
+        BOOST_CHECK(res == value);
+    }
+    BOOST_CHECK(!dbw.Exists(InsecureRand256()));
+}
+
 BOOST_AUTO_TEST_CASE(unicodepath)
 {
     // Attempt to create a database with a UTF8 character in the path.
@@ -0,0 +1,216 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <crypto/sha256.h>
+#include <index/flodataindex.h>
+#include <miner.h>
+#include <node/flodataexport.h>
+#include <pow.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+
+BOOST_AUTO_TEST_SUITE(flodataindex_tests)
+
+static constexpr size_t NO_LIMIT{std::numeric_limits<size_t>::max()};
+
+/** Mine a block with floData in its coinbase on the tip, for its scrypt hash, and connect it. */
+static CBlock MineBlock(ChainstateManager& chainman, const std::string& flo_data)
+{
+    CTxMemPool empty_pool;
+    CBlock block = BlockAssembler(chainman.ActiveChainstate(), empty_pool, Params()).CreateNewBlock(CScript() << OP_TRUE, flo_data)->block;
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, Params().GetConsensus())) ++block.nNonce;
+    BOOST_REQUIRE(chainman.ProcessNewBlock(Params(), std::make_shared<const CBlock>(block), true, nullptr));
+    BOOST_REQUIRE(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()->GetBlockHash()) == block.GetHash());
+    return block;
+}
+
+BOOST_FIXTURE_TEST_CASE(flodataindex_initial_sync, RegTestingSetup)
+{
+    FloDataIndex flodataindex(1 << 20, true);
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+
+    // Blocks connected before the index is started are picked up by the
+    // initial sync. Searches start above the genesis block, which has floData.
+    const CBlock block_hello = MineBlock(chainman, "text:hello");
+    const CBlock block_other = MineBlock(chainman, "other");
+
+    std::vector<FloDataIndexEntry> entries;
+    BOOST_CHECK(flodataindex.FindByPrefix("text:", 1, 1000, NO_LIMIT, entries));
+    BOOST_CHECK(entries.empty());
+
+    BOOST_REQUIRE(flodataindex.Start(m_node.chainman->ActiveChainstate()));
+
+    // Allow the index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!flodataindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // New blocks make it into the index.
+    const CBlock block_world = MineBlock(chainman, "text:world");
+    BOOST_CHECK(flodataindex.BlockUntilSyncedToCurrentChain());
+
+    const int tip_height = WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Height());
+
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByPrefix("text:", 1, tip_height, NO_LIMIT, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+    BOOST_CHECK(entries[0].txid == block_hello.vtx[0]->GetHash());
+    BOOST_CHECK_EQUAL(entries[0].height, tip_height - 2);
+    BOOST_CHECK(entries[0].block_hash == block_hello.GetHash());
+    BOOST_CHECK(entries[1].txid == block_world.vtx[0]->GetHash());
+    BOOST_CHECK_EQUAL(entries[1].height, tip_height);
+
+    // The height range is honoured.
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByPrefix("text:", tip_height, tip_height, NO_LIMIT, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 1U);
+    BOOST_CHECK(entries[0].txid == block_world.vtx[0]->GetHash());
+
+    // The count is honoured, in floData order.
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByPrefix("text:", 1, tip_height, 1, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 1U);
+    BOOST_CHECK(entries[0].txid == block_hello.vtx[0]->GetHash());
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByPrefix("text:w", 0, tip_height - 1, NO_LIMIT, entries));
+    BOOST_CHECK(entries.empty());
+
+    // Prefixes longer than the floData do not match.
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByPrefix("otherwise", 0, tip_height, NO_LIMIT, entries));
+    BOOST_CHECK(entries.empty());
+
+    // Lookup by content hash.
+    uint256 hash;
+    CSHA256().Write((const unsigned char*)"other", 5).Finalize(hash.begin());
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByHash(hash, 0, tip_height, NO_LIMIT, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 1U);
+    BOOST_CHECK(entries[0].txid == block_other.vtx[0]->GetHash());
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByHash(hash, tip_height, tip_height, NO_LIMIT, entries));
+    BOOST_CHECK(entries.empty());
+
+    // Prefixes longer than the indexed size are rejected.
+    BOOST_CHECK(!flodataindex.FindByPrefix(std::string(FLODATA_INDEX_PREFIX_SIZE + 1, 'a'), 0, tip_height, NO_LIMIT, entries));
+
+    // Per-block statistics are stored for every block.
+    FloDataBlockStats stats;
+    const CBlockIndex* tip = WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip());
+    BOOST_CHECK(flodataindex.LookUpBlockStats(tip, stats));
+    BOOST_CHECK_EQUAL(stats.count, 1U);
+    BOOST_CHECK_EQUAL(stats.total_bytes, 10U);
+    BOOST_CHECK_EQUAL(stats.max_size, 10U);
+    BOOST_CHECK(stats.prefixes == (std::map<std::string, uint64_t>{{"text:", 1}}));
+    BOOST_CHECK(flodataindex.LookUpBlockStats(tip->pprev, stats));
+    BOOST_CHECK(stats.prefixes == (std::map<std::string, uint64_t>{{"", 1}}));
+
+    // Entries of blocks that were reorganized away are not returned.
+    BlockValidationState state;
+    BOOST_REQUIRE(chainman.ActiveChainstate().InvalidateBlock(state, WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(block_world.GetHash()))));
+    const CBlock block_again = MineBlock(chainman, "text:again");
+    BOOST_CHECK(flodataindex.BlockUntilSyncedToCurrentChain());
+    entries.clear();
+    BOOST_CHECK(flodataindex.FindByPrefix("text:", 1, tip_height, NO_LIMIT, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+    BOOST_CHECK(entries[0].txid == block_again.vtx[0]->GetHash());
+    BOOST_CHECK_EQUAL(entries[0].height, tip_height);
+    BOOST_CHECK(entries[1].txid == block_hello.vtx[0]->GetHash());
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    flodataindex.Stop();
+
+    // Let scheduler events finish running to avoid accessing any memory related to the index after it is destructed
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_CASE(flodata_block_stats)
+{
+    FloDataBlockStats stats;
+    stats.Add("");
+    BOOST_CHECK_EQUAL(stats.count, 0U);
+
+    stats.Add("text:a");
+    stats.Add("text:bc");
+    stats.Add("no separator");
+    stats.Add(std::string(FLODATA_INDEX_PREFIX_SIZE, 'x') + ":late");
+    BOOST_CHECK_EQUAL(stats.count, 4U);
+    BOOST_CHECK_EQUAL(stats.total_bytes, 6U + 7U + 12U + FLODATA_INDEX_PREFIX_SIZE + 5U);
+    BOOST_CHECK_EQUAL(stats.max_size, FLODATA_INDEX_PREFIX_SIZE + 5U);
+    BOOST_CHECK(stats.prefixes == (std::map<std::string, uint64_t>{{"", 2}, {"text:", 2}}));
+}
+
+BOOST_FIXTURE_TEST_CASE(flodata_export, RegTestingSetup)
+{
+    std::vector<CBlock> flo_data_blocks;
+    for (const std::string flo_data : {"text:first", "", "text:second"}) {
+        const CBlock block = MineBlock(*Assert(m_node.chainman), flo_data);
+        if (!flo_data.empty()) flo_data_blocks.push_back(block);
+    }
+
+    std::vector<FloDataExportBlock> blocks;
+    int tip_height;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain = m_node.chainman->ActiveChain();
+        tip_height = active_chain.Height();
+        // Leave out the genesis block and its floData.
+        for (int height = 1; height <= tip_height; ++height) {
+            blocks.push_back({active_chain[height], active_chain[height]->GetBlockPos()});
+        }
+    }
+
+    const fs::path path = m_args.GetDataDirNet() / "flodata.dat";
+    FloDataExportStats stats;
+    {
+        CAutoFile afile{fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION};
+        BOOST_REQUIRE(ExportFloData(blocks, FloDataExportFormat::BINARY, 4, afile.Get(), stats, [] { return false; }));
+    }
+    BOOST_CHECK_EQUAL(stats.blocks, blocks.size());
+    BOOST_CHECK_EQUAL(stats.transactions, 2U);
+
+    CAutoFile afile{fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION};
+    for (size_t i = 0; i < flo_data_blocks.size(); ++i) {
+        uint256 txid;
+        int height;
+        std::string flo_data;
+        afile >> txid >> height >> flo_data;
+        BOOST_CHECK(txid == flo_data_blocks[i].vtx[0]->GetHash());
+        BOOST_CHECK_EQUAL(height, tip_height - 2 + 2 * (int)i);
+        BOOST_CHECK_EQUAL(flo_data, flo_data_blocks[i].vtx[0]->strFloData.str());
+    }
+    BOOST_CHECK_EQUAL(fgetc(afile.Get()), EOF);
+
+    // An interrupted export fails.
+    CAutoFile afile_interrupted{fsbridge::fopen(m_args.GetDataDirNet() / "flodata2.dat", "wb"), SER_DISK, CLIENT_VERSION};
+    BOOST_CHECK(!ExportFloData(blocks, FloDataExportFormat::NDJSON, 1, afile_interrupted.Get(), stats, [] { return true; }));
+
+    // Blocks found at a position other than the one chosen, or pruned since, fail the export.
+    std::vector<FloDataExportBlock> moved{blocks};
+    std::swap(moved[1].pos, moved[2].pos);
+    CAutoFile afile_moved{fsbridge::fopen(m_args.GetDataDirNet() / "flodata3.dat", "wb"), SER_DISK, CLIENT_VERSION};
+    BOOST_CHECK(!ExportFloData(moved, FloDataExportFormat::NDJSON, 1, afile_moved.Get(), stats, [] { return false; }));
+
+    CBlockIndex* pruned = WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[1]);
+    WITH_LOCK(cs_main, pruned->nStatus &= ~BLOCK_HAVE_DATA);
+    CAutoFile afile_pruned{fsbridge::fopen(m_args.GetDataDirNet() / "flodata4.dat", "wb"), SER_DISK, CLIENT_VERSION};
+    BOOST_CHECK(!ExportFloData(blocks, FloDataExportFormat::NDJSON, 1, afile_pruned.Get(), stats, [] { return false; }));
+    WITH_LOCK(cs_main, pruned->nStatus |= BLOCK_HAVE_DATA);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -67,6 +67,7 @@ const std::vector<std::string> RPC_COMMANDS_NOT_SAFE_FOR_FUZZING{
     "addnode",        // avoid DNS lookups
     "addpeeraddress", // avoid DNS lookups
     "analyzepsbt",    // avoid signed integer overflow in CFeeRate::GetFee(unsigned long) (https://github.com/flocoin/flocoin/issues/20607)
+    "dumpflodata",    // avoid writing to disk
     "dumptxoutset",   // avoid writing to disk
     "dumpwallet", // avoid writing to disk
     "echoipc",              // avoid assertion failure (Assertion `"EnsureAnyNodeContext(request.context).init" && check' failed.)
@@ -114,6 +115,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getblocktemplate",
     "getchaintips",
     "getchaintxstats",
+    "getcoinscacheinfo",
     "getconnectioncount",
     "getdescriptorinfo",
     "getdifficulty",
@@ -132,6 +134,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawmempool",
     "getrawtransaction",
     "getrpcinfo",
+    "getscryptinfo",
     "gettxout",
     "gettxoutsetinfo",
     "help",
@@ -145,6 +148,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "pruneblockchain",
     "reconsiderblock",
     "scantxoutset",
+    "searchflodata",
     "sendrawtransaction",
     "setmocktime",
     "setnetworkactive",
@@ -8,8 +8,10 @@
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
+#include <crypto/scrypt.h>
 #include <miner.h>
 #include <policy/policy.h>
+#include <pow.h>
 #include <script/standard.h>
 #include <txmempool.h>
 #include <uint256.h>
@@ -528,4 +530,54 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+BOOST_AUTO_TEST_CASE(SearchNonce_lowest)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, CBaseChainParams::REGTEST);
+    const Consensus::Params& consensus = chainParams->GetConsensus();
+    CBlockHeader header = chainParams->GenesisBlock().GetBlockHeader();
+    header.nBits = 0x2003ffff; // About one in 64 hashes is valid
+    header.nNonce = 0;
+
+    // The lowest valid nonce, as a single-threaded search finds it.
+    uint32_t expected_nonce = 0;
+    CBlockHeader expected = header;
+    while (!CheckProofOfWork(expected.GetPoWHash(), expected.nBits, consensus)) {
+        expected_nonce = ++expected.nNonce;
+    }
+
+    for (int threads : {1, 4}) {
+        CBlockHeader found = header;
+        uint64_t max_tries = 100000;
+        BOOST_CHECK(SearchNonce(found, consensus, threads, max_tries));
+        BOOST_CHECK_EQUAL(found.nNonce, expected_nonce);
+        BOOST_CHECK_EQUAL(max_tries, 100000U - expected_nonce);
+    }
+
+    // Easy targets are searched one nonce at a time, so that no hash is wasted.
+    const auto count_hashes = [] {
+        uint64_t total{0};
+        for (const auto& [name, hashes] : ScryptGetHashCounts()) {
+            total += hashes;
+        }
+        return total;
+    };
+    for (uint32_t nonce = 0; nonce < 20; ++nonce) {
+        CBlockHeader easy = chainParams->GenesisBlock().GetBlockHeader();
+        easy.nNonce = nonce;
+        uint64_t max_tries = 100;
+        const uint64_t hashes = count_hashes();
+        BOOST_CHECK(SearchNonce(easy, consensus, /*threads=*/4, max_tries));
+        BOOST_CHECK_EQUAL(count_hashes() - hashes, easy.nNonce - nonce + 1);
+    }
+
+    // Running out of tries leaves the nonce at the first untried one.
+    CBlockHeader impossible = header;
+    impossible.nBits = 0x03000001;
+    uint64_t max_tries = 37;
+    BOOST_CHECK(!SearchNonce(impossible, consensus, 4, max_tries));
+    BOOST_CHECK_EQUAL(impossible.nNonce, 37U);
+    BOOST_CHECK_EQUAL(max_tries, 0U);
+    BOOST_CHECK(GetSearchNonceHashRate());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <memusage.h>
+#include <support/allocators/pool.h>
+#include <test/util/setup_common.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(pool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(basic_allocating)
+{
+    PoolResource<8, 8> resource(1024);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 0U);
+    BOOST_CHECK_EQUAL(resource.ChunkSizeBytes(), 1024U);
+
+    // A freed block is handed out again by the next allocation of its size.
+    void* block = resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    resource.Deallocate(block, 8, 8);
+    BOOST_CHECK_EQUAL(resource.Allocate(8, 8), block);
+
+    // Zero sized blocks still get memory of their own.
+    void* empty = resource.Allocate(0, 1);
+    BOOST_CHECK(empty != block);
+
+    // Blocks that are too large or too strictly aligned for the pool do not
+    // come from a chunk.
+    void* large = resource.Allocate(16, 8);
+    void* aligned = resource.Allocate(8, 16);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    resource.Deallocate(large, 16, 8);
+    resource.Deallocate(aligned, 8, 16);
+
+    resource.Deallocate(empty, 0, 1);
+    resource.Deallocate(block, 8, 8);
+}
+
+BOOST_AUTO_TEST_CASE(chunks)
+{
+    PoolResource<16, 8> resource(64);
+
+    // Fill the first chunk completely.
+    std::vector<void*> blocks;
+    for (int i = 0; i < 4; ++i) {
+        blocks.push_back(resource.Allocate(16, 8));
+    }
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    for (size_t i = 1; i < blocks.size(); ++i) {
+        BOOST_CHECK_EQUAL(static_cast<std::byte*>(blocks[i]) - static_cast<std::byte*>(blocks[i - 1]), 16);
+    }
+
+    // The next allocation needs a new chunk, unless a block was freed.
+    resource.Deallocate(blocks.back(), 16, 8);
+    BOOST_CHECK_EQUAL(resource.Allocate(16, 8), blocks.back());
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    blocks.push_back(resource.Allocate(16, 8));
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+
+    // The rest of a chunk too small for a block is kept for smaller blocks.
+    blocks.push_back(resource.Allocate(8, 8));
+    blocks.push_back(resource.Allocate(16, 8));
+    blocks.push_back(resource.Allocate(16, 8));
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    blocks.push_back(resource.Allocate(16, 8));
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 3U);
+    void* rest = resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(static_cast<std::byte*>(rest) - static_cast<std::byte*>(blocks[7]), 16);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(random_allocations)
+{
+    PoolResource<128, 8> resource(1024);
+    std::vector<std::pair<std::byte*, size_t>> blocks;
+    for (int i = 0; i < 10000; ++i) {
+        if (blocks.empty() || InsecureRandBool()) {
+            const size_t size = InsecureRandRange(256);
+            std::byte* block = static_cast<std::byte*>(resource.Allocate(size, 8));
+            BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(block) % 8, 0U);
+            // Fill the block, so that overlapping blocks are detected below.
+            std::fill(block, block + size, std::byte(size));
+            blocks.emplace_back(block, size);
+        } else {
+            const size_t index = InsecureRandRange(blocks.size());
+            const auto [block, size] = blocks[index];
+            for (size_t n = 0; n < size; ++n) {
+                BOOST_REQUIRE(block[n] == std::byte(size));
+            }
+            resource.Deallocate(block, size, 8);
+            blocks[index] = blocks.back();
+            blocks.pop_back();
+        }
+    }
+    for (const auto& [block, size] : blocks) {
+        resource.Deallocate(block, size, 8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pool_unordered_map)
+{
+    using Map = std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                   PoolAllocator<std::pair<const uint64_t, uint64_t>, 64, alignof(void*)>>;
+    Map::allocator_type::ResourceType resource(4096);
+    Map map{0, Map::hasher{}, Map::key_equal{}, &resource};
+    std::map<uint64_t, uint64_t> expected;
+
+    for (int i = 0; i < 20000; ++i) {
+        const uint64_t key = InsecureRandRange(5000);
+        if (InsecureRandBool()) {
+            const uint64_t value = InsecureRandBits(64);
+            map[key] = value;
+            expected[key] = value;
+        } else {
+            BOOST_CHECK_EQUAL(map.erase(key), expected.erase(key));
+        }
+    }
+    BOOST_CHECK_EQUAL(map.size(), expected.size());
+    for (const auto& [key, value] : expected) {
+        BOOST_CHECK_EQUAL(map.at(key), value);
+    }
+
+    // The nodes come from the pool, and are accounted as whole chunks.
+    BOOST_CHECK(resource.NumAllocatedChunks() > 0);
+    BOOST_CHECK(resource.NumAllocatedChunks() * resource.ChunkSizeBytes() >= map.size() * sizeof(Map::value_type));
+    BOOST_CHECK(memusage::DynamicUsage(map) >= resource.NumAllocatedChunks() * resource.ChunkSizeBytes());
+
+    // Memory is reused, rather than allocated again.
+    const size_t chunks = resource.NumAllocatedChunks();
+    map.clear();
+    for (const auto& [key, value] : expected) {
+        map.emplace(key, value);
+    }
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), chunks);
+}
+
+BOOST_AUTO_TEST_CASE(coins_map)
+{
+    CCoinsMapMemoryResource resource;
+    CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), memusage::MallocUsage(sizeof(void*) * map.bucket_count()));
+
+    // Whatever the node size of the standard library, nodes are allocated
+    // from the pool, so usage only grows by whole chunks.
+    for (uint32_t n = 0; n < 1000; ++n) {
+        map.try_emplace(COutPoint{InsecureRand256(), n});
+    }
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map),
+                      memusage::MallocUsage(resource.ChunkSizeBytes()) +
+                      memusage::MallocUsage(sizeof(void*)) +
+                      memusage::MallocUsage(sizeof(void*) * map.bucket_count()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
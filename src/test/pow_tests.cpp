@@ -135,6 +135,53 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+/* Test that the skip list lookup of the averaging window matches a pprev walk across all retarget versions */
+BOOST_AUTO_TEST_CASE(get_next_work_averaging_window)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, CBaseChainParams::TESTNET);
+    const Consensus::Params& consensus = chainParams->GetConsensus();
+    const int num_blocks = consensus.nHeight_Difficulty_Version3 + 100;
+    std::vector<CBlockIndex> blocks(num_blocks);
+    for (int i = 0; i < num_blocks; i++) {
+        blocks[i].pprev = i ? &blocks[i - 1] : nullptr;
+        blocks[i].nHeight = i;
+        blocks[i].nTime = 1371387277 + i * consensus.nPowTargetSpacing + InsecureRandRange(consensus.nPowTargetSpacing);
+        blocks[i].nBits = 0x1e0ffff0;
+        blocks[i].BuildSkip();
+    }
+
+    for (int i = 1; i < num_blocks; i++) {
+        const CBlockIndex* pindexLast = &blocks[i - 1];
+        if (i % consensus.DifficultyAdjustmentInterval(pindexLast->nHeight) != 0) continue;
+        const int averagingInterval = consensus.AveragingInterval(i);
+        const int blockstogoback = i != averagingInterval ? averagingInterval : averagingInterval - 1;
+        const CBlockIndex* pindexFirst = pindexLast;
+        for (int j = 0; j < blockstogoback; j++) {
+            pindexFirst = pindexFirst->pprev;
+        }
+        CBlockHeader header;
+        header.nTime = pindexLast->nTime + consensus.nPowTargetSpacing;
+        BOOST_CHECK_EQUAL(GetNextWorkRequired(pindexLast, &header, consensus),
+                          CalculateNextWorkRequired(pindexLast, pindexFirst->GetBlockTime(), consensus));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GetPoWHashes_test)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, CBaseChainParams::MAIN);
+    std::vector<CBlockHeader> headers(21, chainParams->GenesisBlock().GetBlockHeader());
+    for (size_t i = 1; i < headers.size(); i++) {
+        headers[i].nNonce = InsecureRand32();
+        headers[i].nTime += i;
+    }
+    const std::vector<uint256> hashes = GetPoWHashes(headers);
+    BOOST_REQUIRE_EQUAL(hashes.size(), headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        BOOST_CHECK_EQUAL(hashes[i], headers[i].GetPoWHash());
+    }
+    BOOST_CHECK(CheckProofOfWork(hashes[0], headers[0].nBits, chainParams->GetConsensus()));
+}
+
 void sanity_check_chainparams(const ArgsManager& args, std::string chainName)
 {
     const auto chainParams = CreateChainParams(args, chainName);
@@ -0,0 +1,80 @@
+// Copyright (c) 2021 Flo Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <node/powaudit.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+#include <versionbits.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(powaudit_tests, RegTestingSetup)
+
+BOOST_AUTO_TEST_CASE(powaudit_repairs_and_invalidates)
+{
+    // Headers on top of the genesis block, mined for their scrypt hash.
+    std::vector<CBlockHeader> headers;
+    CBlockHeader prev = Params().GenesisBlock().GetBlockHeader();
+    for (int i = 0; i < 10; ++i) {
+        CBlockHeader header;
+        header.nVersion = VERSIONBITS_TOP_BITS;
+        header.hashPrevBlock = prev.GetHash();
+        header.hashMerkleRoot = InsecureRand256();
+        header.nTime = prev.nTime + 1;
+        header.nBits = prev.nBits;
+        while (!CheckProofOfWork(header.GetPoWHash(), header.nBits, Params().GetConsensus())) {
+            ++header.nNonce;
+        }
+        headers.push_back(header);
+        prev = header;
+    }
+    BlockValidationState state;
+    BOOST_REQUIRE(Assert(m_node.chainman)->ProcessNewBlockHeaders(headers, state, Params()));
+
+    CBlockIndex* missing;
+    CBlockIndex* mismatching;
+    CBlockIndex* failing;
+    {
+        LOCK(cs_main);
+        missing = m_node.chainman->m_blockman.LookupBlockIndex(headers[2].GetHash());
+        mismatching = m_node.chainman->m_blockman.LookupBlockIndex(headers[5].GetHash());
+        failing = m_node.chainman->m_blockman.LookupBlockIndex(headers[8].GetHash());
+        BOOST_REQUIRE(missing && mismatching && failing);
+        missing->nStatus &= ~BLOCK_HAVE_POW_HASH;
+        missing->hashPoW.SetNull();
+        mismatching->hashPoW = InsecureRand256();
+        // A target the header's hash does not meet.
+        failing->nBits = 0x1d00ffff;
+    }
+
+    PoWAudit audit{*m_node.chainman};
+    audit.Start(/*threads_num=*/2);
+    while (audit.GetProgress().running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    audit.Stop();
+
+    const PoWAudit::Progress progress = audit.GetProgress();
+    BOOST_CHECK_EQUAL(progress.total, headers.size() + 1);
+    BOOST_CHECK_EQUAL(progress.checked, progress.total);
+    BOOST_CHECK_EQUAL(progress.corrupt, 1U);
+
+    LOCK(cs_main);
+    BOOST_CHECK(missing->nStatus & BLOCK_HAVE_POW_HASH);
+    BOOST_CHECK(missing->hashPoW == headers[2].GetPoWHash());
+    BOOST_CHECK(mismatching->hashPoW == headers[5].GetPoWHash());
+    BOOST_CHECK(failing->nStatus & BLOCK_FAILED_VALID);
+    BOOST_CHECK(!(mismatching->nStatus & BLOCK_FAILED_MASK));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -123,6 +123,34 @@ BOOST_AUTO_TEST_CASE(streams_vector_reader_rvalue)
     BOOST_CHECK(reader.empty());
 }
 
+BOOST_AUTO_TEST_CASE(streams_span_reader)
+{
+    const std::vector<unsigned char> vch = {1, 255, 3, 4, 5, 6};
+
+    SpanReader reader(SER_NETWORK, INIT_PROTO_VERSION, vch);
+    BOOST_CHECK_EQUAL(reader.size(), 6U);
+
+    unsigned char a;
+    signed char b;
+    reader >> a >> b;
+    BOOST_CHECK_EQUAL(a, 1);
+    BOOST_CHECK_EQUAL(b, -1);
+    BOOST_CHECK_EQUAL(reader.size(), 4U);
+
+    // Reading past the end throws, and leaves the stream unchanged.
+    uint64_t c;
+    BOOST_CHECK_THROW(reader >> c, std::ios_base::failure);
+    BOOST_CHECK_EQUAL(reader.size(), 4U);
+
+    reader.ignore(1);
+    uint16_t d;
+    reader >> d;
+    BOOST_CHECK_EQUAL(d, 1284U); // 4,5 in little-endian base-256
+    BOOST_CHECK_THROW(reader.ignore(2), std::ios_base::failure);
+    reader.ignore(1);
+    BOOST_CHECK(reader.empty());
+}
+
 BOOST_AUTO_TEST_CASE(bitstream_reader_writer)
 {
     CDataStream data(SER_NETWORK, INIT_PROTO_VERSION);
@@ -10,6 +10,7 @@
 #include <clientversion.h>
 #include <consensus/tx_check.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <core_io.h>
 #include <key.h>
 #include <policy/policy.h>
@@ -958,4 +959,35 @@ BOOST_AUTO_TEST_CASE(test_IsStandard)
     fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 }
 
+BOOST_AUTO_TEST_CASE(flodata_memusage)
+{
+    CMutableTransaction mtx;
+    mtx.vin.resize(1);
+    mtx.vout.resize(1);
+    const size_t usage_without_flodata = RecursiveDynamicUsage(CTransaction(mtx));
+
+    // Empty floData needs no allocation.
+    mtx.strFloData = "";
+    BOOST_CHECK(!mtx.strFloData.GetShared());
+    BOOST_CHECK_EQUAL(RecursiveDynamicUsage(CTransaction(mtx)), usage_without_flodata);
+
+    // floData is accounted for, and shared rather than copied between
+    // CMutableTransaction and CTransaction.
+    mtx.strFloData = std::string(CTransaction::MAX_FLO_DATA_SIZE, 'f');
+    const size_t flo_data_usage = memusage::DynamicUsage(mtx.strFloData.GetShared()) + memusage::MallocUsage(CTransaction::MAX_FLO_DATA_SIZE + 1);
+    BOOST_CHECK_EQUAL(RecursiveDynamicUsage(mtx), usage_without_flodata + flo_data_usage);
+    const char* flo_data = mtx.strFloData.data();
+    const CTransaction tx(mtx);
+    BOOST_CHECK(tx.strFloData.data() == flo_data);
+    BOOST_CHECK(CMutableTransaction(tx).strFloData.data() == flo_data);
+    BOOST_CHECK_EQUAL(RecursiveDynamicUsage(tx), usage_without_flodata + flo_data_usage);
+
+    // Deserialized floData does not over-allocate.
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << tx;
+    const CTransaction tx_read(deserialize, ss);
+    BOOST_CHECK(tx_read.strFloData == tx.strFloData);
+    BOOST_CHECK_EQUAL(RecursiveDynamicUsage(tx_read), usage_without_flodata + flo_data_usage);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
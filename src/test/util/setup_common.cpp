@@ -10,6 +10,7 @@
 #include <consensus/consensus.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha256.h>
 #include <init.h>
 #include <interfaces/chain.h>
@@ -108,6 +109,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName, const std::ve
     AppInitParameterInteraction(*m_node.args);
     LogInstance().StartLogging();
     SHA256AutoDetect();
+    ScryptAutoDetect();
     ECC_Start();
     SetupEnvironment();
     SetupNetworking();
@@ -7,6 +7,7 @@
 #include <chainparams.h>
 #include <consensus/merkle.h>
 #include <consensus/validation.h>
+#include <crypto/scrypt.h>
 #include <miner.h>
 #include <pow.h>
 #include <random.h>
@@ -16,6 +17,7 @@
 #include <util/time.h>
 #include <validation.h>
 #include <validationinterface.h>
+#include <versionbits.h>
 
 #include <thread>
 
@@ -218,6 +220,59 @@ BOOST_AUTO_TEST_CASE(processnewblock_signals_ordering)
  * or consistent with the chain state after the reorg, and not just consistent
  * with some intermediate state during the reorg.
  */
+BOOST_AUTO_TEST_CASE(processnewblockheaders_pow)
+{
+    const auto count_hashes = [] {
+        uint64_t total{0};
+        for (const auto& [name, hashes] : ScryptGetHashCounts()) {
+            total += hashes;
+        }
+        return total;
+    };
+
+    // A chain of valid headers on top of the genesis block.
+    std::vector<CBlockHeader> headers;
+    CBlockHeader prev = Params().GenesisBlock().GetBlockHeader();
+    for (int i = 0; i < 10; ++i) {
+        CBlockHeader header;
+        header.nVersion = VERSIONBITS_TOP_BITS;
+        header.hashPrevBlock = prev.GetHash();
+        header.hashMerkleRoot = InsecureRand256();
+        header.nTime = prev.nTime + 1;
+        header.nBits = prev.nBits;
+        while (!CheckProofOfWork(header.GetPoWHash(), header.nBits, Params().GetConsensus())) {
+            ++header.nNonce;
+        }
+        headers.push_back(header);
+        prev = header;
+    }
+
+    // Headers none of which meets its target cost one hash for the first
+    // header, and one more to report its failure, however many there are.
+    std::vector<CBlockHeader> bad_headers(1000, headers[0]);
+    for (CBlockHeader& header : bad_headers) {
+        header.hashMerkleRoot = InsecureRand256();
+        header.nBits = 0x1d00ffff;
+    }
+    BlockValidationState state;
+    uint64_t hashes = count_hashes();
+    BOOST_CHECK(!Assert(m_node.chainman)->ProcessNewBlockHeaders(bad_headers, state, Params()));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    BOOST_CHECK_EQUAL(count_hashes() - hashes, 2U);
+
+    // Valid headers are hashed once each, and keep their hash.
+    state = BlockValidationState();
+    hashes = count_hashes();
+    BOOST_CHECK(Assert(m_node.chainman)->ProcessNewBlockHeaders(headers, state, Params()));
+    BOOST_CHECK_EQUAL(count_hashes() - hashes, headers.size());
+    LOCK(cs_main);
+    for (const CBlockHeader& header : headers) {
+        const CBlockIndex* pindex = m_node.chainman->m_blockman.LookupBlockIndex(header.GetHash());
+        BOOST_REQUIRE(pindex);
+        BOOST_CHECK(pindex->nStatus & BLOCK_HAVE_POW_HASH);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(mempool_locks_reorg)
 {
     bool ignored;
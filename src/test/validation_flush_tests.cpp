@@ -81,64 +81,46 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
     print_view_mem_usage(view);
     BOOST_CHECK_EQUAL(view.DynamicMemoryUsage(), is_64_bit ? 32U : 16U);
 
-    // We should be able to add COINS_UNTIL_CRITICAL coins to the cache before going CRITICAL.
-    // This is contingent not only on the dynamic memory usage of the Coins
-    // that we're adding (COIN_SIZE bytes per), but also on how much memory the
-    // cacheCoins (unordered_map) preallocates.
+    // The first coin makes the pool backing cacheCoins allocate a chunk, which
+    // then holds the nodes of the following coins as well. Until the chunk is
+    // full or the map rehashes, usage only grows by COIN_SIZE per coin.
+    add_coin(view);
+    print_view_mem_usage(view);
+    BOOST_CHECK(view.DynamicMemoryUsage() > CCoinsMapMemoryResource{}.ChunkSizeBytes());
+    BOOST_CHECK_EQUAL(
+        chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 0),
+        CoinsCacheSizeState::CRITICAL);
+
+    // Leave room for COINS_UNTIL_CRITICAL more coins, few enough not to
+    // trigger a rehash of cacheCoins.
     constexpr int COINS_UNTIL_CRITICAL{3};
+    const size_t max_coins_cache_bytes = view.DynamicMemoryUsage() + COINS_UNTIL_CRITICAL * COIN_SIZE;
 
     for (int i{0}; i < COINS_UNTIL_CRITICAL; ++i) {
         COutPoint res = add_coin(view);
         print_view_mem_usage(view);
         BOOST_CHECK_EQUAL(view.AccessCoin(res).DynamicMemoryUsage(), COIN_SIZE);
+        // This close to the limit the cache is above the 90% mark.
         BOOST_CHECK_EQUAL(
-            chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 0),
-            CoinsCacheSizeState::OK);
-    }
-
-    // Adding some additional coins will push us over the edge to CRITICAL.
-    for (int i{0}; i < 4; ++i) {
-        add_coin(view);
-        print_view_mem_usage(view);
-        if (chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 0) ==
-            CoinsCacheSizeState::CRITICAL) {
-            break;
-        }
+            chainstate.GetCoinsCacheSizeState(max_coins_cache_bytes, /*max_mempool_size_bytes*/ 0),
+            CoinsCacheSizeState::LARGE);
     }
 
+    // Adding one more coin pushes us over the edge to CRITICAL.
+    add_coin(view);
+    print_view_mem_usage(view);
     BOOST_CHECK_EQUAL(
-        chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 0),
+        chainstate.GetCoinsCacheSizeState(max_coins_cache_bytes, /*max_mempool_size_bytes*/ 0),
         CoinsCacheSizeState::CRITICAL);
 
     // Passing non-zero max mempool usage should allow us more headroom.
     BOOST_CHECK_EQUAL(
-        chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 1 << 10),
+        chainstate.GetCoinsCacheSizeState(max_coins_cache_bytes, /*max_mempool_size_bytes*/ 1 << 10),
+        CoinsCacheSizeState::LARGE);
+    BOOST_CHECK_EQUAL(
+        chainstate.GetCoinsCacheSizeState(max_coins_cache_bytes, /*max_mempool_size_bytes*/ max_coins_cache_bytes / 2),
         CoinsCacheSizeState::OK);
 
-    for (int i{0}; i < 3; ++i) {
-        add_coin(view);
-        print_view_mem_usage(view);
-        BOOST_CHECK_EQUAL(
-            chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 1 << 10),
-            CoinsCacheSizeState::OK);
-    }
-
-    // Adding another coin with the additional mempool room will put us >90%
-    // but not yet critical.
-    add_coin(view);
-    print_view_mem_usage(view);
-
-    // Only perform these checks on 64 bit hosts; I haven't done the math for 32.
-    if (is_64_bit) {
-        float usage_percentage = (float)view.DynamicMemoryUsage() / (MAX_COINS_CACHE_BYTES + (1 << 10));
-        BOOST_TEST_MESSAGE("CoinsTip usage percentage: " << usage_percentage);
-        BOOST_CHECK(usage_percentage >= 0.9);
-        BOOST_CHECK(usage_percentage < 1);
-        BOOST_CHECK_EQUAL(
-            chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, 1 << 10),
-            CoinsCacheSizeState::LARGE);
-    }
-
     // Using the default max_* values permits way more coins to be added.
     for (int i{0}; i < 1000; ++i) {
         add_coin(view);
@@ -147,11 +129,11 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
             CoinsCacheSizeState::OK);
     }
 
-    // Flushing the view doesn't take us back to OK because cacheCoins has
-    // preallocated memory that doesn't get reclaimed even after flush.
+    // Flushing the view doesn't take us back to OK because the pool and the
+    // buckets of cacheCoins keep their memory even after flush.
 
     BOOST_CHECK_EQUAL(
-        chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, 0),
+        chainstate.GetCoinsCacheSizeState(max_coins_cache_bytes, 0),
         CoinsCacheSizeState::CRITICAL);
 
     view.SetBestBlock(InsecureRand256());
@@ -159,7 +141,7 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
     print_view_mem_usage(view);
 
     BOOST_CHECK_EQUAL(
-        chainstate.GetCoinsCacheSizeState(MAX_COINS_CACHE_BYTES, 0),
+        chainstate.GetCoinsCacheSizeState(max_coins_cache_bytes, 0),
         CoinsCacheSizeState::CRITICAL);
 }
 
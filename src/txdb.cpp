@@ -11,10 +11,12 @@
 #include <shutdown.h>
 #include <uint256.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <util/vector.h>
 
 #include <stdint.h>
+#include <utility>
 
 static constexpr uint8_t DB_COIN{'C'};
 static constexpr uint8_t DB_COINS{'c'};
@@ -39,33 +41,82 @@ struct CoinEntry {
 
 }
 
-CCoinsViewDB::CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, bool fWipe) :
-    m_db(std::make_unique<CDBWrapper>(ldb_path, nCacheSize, fMemory, fWipe, true)),
+CCoinsViewDB::CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, bool fWipe, bool background_flush, const DBOptions& db_options) :
+    m_db(std::make_unique<CDBWrapper>(ldb_path, nCacheSize, fMemory, fWipe, true, db_options)),
     m_ldb_path(ldb_path),
-    m_is_memory(fMemory) { }
+    m_is_memory(fMemory),
+    m_db_options(db_options)
+{
+    if (background_flush) {
+        m_writer_thread = std::thread([this]() {
+            util::ThreadRename("coinsflush");
+            ThreadWrite();
+        });
+    }
+}
+
+CCoinsViewDB::~CCoinsViewDB()
+{
+    if (m_writer_thread.joinable()) {
+        // The writer finishes the batch it has before stopping.
+        WITH_LOCK(m_writer_mutex, m_writer_stop = true);
+        m_writer_cond.notify_all();
+        m_writer_thread.join();
+    }
+}
 
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
     // We can't do this operation with an in-memory DB since we'll lose all the coins upon
     // reset.
     if (!m_is_memory) {
+        // The database can't be reopened while a batch is being written to it.
+        Sync();
         // Have to do a reset first to get the original `m_db` state to release its
         // filesystem lock.
         m_db.reset();
         m_db = std::make_unique<CDBWrapper>(
-            m_ldb_path, new_cache_size, m_is_memory, /*fWipe*/ false, /*obfuscate*/ true);
+            m_ldb_path, new_cache_size, m_is_memory, /*fWipe*/ false, /*obfuscate*/ true, m_db_options);
     }
 }
 
+const Coin* CCoinsViewDB::FindPendingCoin(const COutPoint& outpoint) const
+{
+    if (!m_pending) return nullptr;
+    auto it = m_pending->m_coins.find(outpoint);
+    return it == m_pending->m_coins.end() ? nullptr : &it->second.coin;
+}
+
 bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    {
+        LOCK(m_writer_mutex);
+        if (const Coin* pending = FindPendingCoin(outpoint)) {
+            if (pending->IsSpent()) return false;
+            coin = *pending;
+            return true;
+        }
+    }
+    // Coins that are not being written are not changed by the writer.
     return m_db->Read(CoinEntry(&outpoint), coin);
 }
 
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
+    {
+        LOCK(m_writer_mutex);
+        if (const Coin* pending = FindPendingCoin(outpoint)) return !pending->IsSpent();
+    }
     return m_db->Exists(CoinEntry(&outpoint));
 }
 
 uint256 CCoinsViewDB::GetBestBlock() const {
+    {
+        LOCK(m_writer_mutex);
+        if (m_pending) return m_pending->m_best_block;
+    }
+    return ReadBestBlock();
+}
+
+uint256 CCoinsViewDB::ReadBestBlock() const {
     uint256 hashBestChain;
     if (!m_db->Read(DB_BEST_BLOCK, hashBestChain))
         return uint256();
@@ -73,6 +124,8 @@ uint256 CCoinsViewDB::GetBestBlock() const {
 }
 
 std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
+    // A batch being written leaves head blocks behind until it is done.
+    Sync();
     std::vector<uint256> vhashHeadBlocks;
     if (!m_db->Read(DB_HEAD_BLOCKS, vhashHeadBlocks)) {
         return std::vector<uint256>();
@@ -81,6 +134,81 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    ++m_write_sequence;
+    if (!m_writer_thread.joinable()) {
+        bool ret = WriteCoins(mapCoins, hashBlock);
+        mapCoins.clear();
+        ++m_write_sequence;
+        return ret;
+    }
+
+    // Take the dirty coins while the previous batch may still be written.
+    auto pending = std::make_unique<PendingWrite>();
+    pending->m_best_block = hashBlock;
+    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end(); it = mapCoins.erase(it)) {
+        if (it->second.flags & CCoinsCacheEntry::DIRTY) {
+            pending->m_coins.emplace(it->first, std::move(it->second));
+        }
+    }
+
+    {
+        WAIT_LOCK(m_writer_mutex, lock);
+        m_writer_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_writer_mutex) { return !m_pending || m_write_failed; });
+        if (m_write_failed) {
+            ++m_write_sequence;
+            return false;
+        }
+        m_pending = std::move(pending);
+    }
+    // The coins are readable from m_pending until they are written.
+    ++m_write_sequence;
+    m_writer_cond.notify_all();
+    return true;
+}
+
+bool CCoinsViewDB::Sync() const
+{
+    WAIT_LOCK(m_writer_mutex, lock);
+    m_writer_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_writer_mutex) { return !m_pending || m_write_failed; });
+    return !m_write_failed;
+}
+
+void CCoinsViewDB::ThreadWrite()
+{
+    WAIT_LOCK(m_writer_mutex, lock);
+    while (true) {
+        m_writer_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_writer_mutex) { return m_writer_stop || m_pending; });
+        if (!m_pending) return;
+
+        // Only this thread resets m_pending, so it can be read without the
+        // lock, as long as nobody modifies it.
+        const PendingWrite& pending = *m_pending;
+        bool ret = false;
+        if (!std::exchange(m_simulate_write_failure, false)) {
+            REVERSE_LOCK(lock);
+            try {
+                ret = WriteCoins(pending.m_coins, pending.m_best_block);
+            } catch (const std::runtime_error& e) {
+                LogPrintf("%s: %s\n", __func__, e.what());
+            }
+        }
+        if (!ret) {
+            // Keep the batch, whose coins the caches no longer have, so that
+            // reads stay consistent until the node has shut down.
+            {
+                REVERSE_LOCK(lock);
+                AbortNode(strprintf("Failed to write coins for %s to the coin database", pending.m_best_block.ToString()));
+            }
+            m_write_failed = true;
+            m_writer_cond.notify_all();
+            return;
+        }
+        m_pending.reset();
+        m_writer_cond.notify_all();
+    }
+}
+
+bool CCoinsViewDB::WriteCoins(const CCoinsMap& mapCoins, const uint256& hashBlock) {
     CDBBatch batch(*m_db);
     size_t count = 0;
     size_t changed = 0;
@@ -88,10 +216,11 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     int crash_simulate = gArgs.GetArg("-dbcrashratio", 0);
     assert(!hashBlock.IsNull());
 
-    uint256 old_tip = GetBestBlock();
+    uint256 old_tip = ReadBestBlock();
     if (old_tip.IsNull()) {
         // We may be in the middle of replaying.
-        std::vector<uint256> old_heads = GetHeadBlocks();
+        std::vector<uint256> old_heads;
+        m_db->Read(DB_HEAD_BLOCKS, old_heads);
         if (old_heads.size() == 2) {
             assert(old_heads[0] == hashBlock);
             old_tip = old_heads[1];
@@ -105,18 +234,16 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
 
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
-        if (it->second.flags & CCoinsCacheEntry::DIRTY) {
-            CoinEntry entry(&it->first);
-            if (it->second.coin.IsSpent())
+    for (const auto& [outpoint, cache_entry] : mapCoins) {
+        if (cache_entry.flags & CCoinsCacheEntry::DIRTY) {
+            CoinEntry entry(&outpoint);
+            if (cache_entry.coin.IsSpent())
                 batch.Erase(entry);
             else
-                batch.Write(entry, it->second.coin);
+                batch.Write(entry, cache_entry.coin);
             changed++;
         }
         count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
             m_db->WriteBatch(batch);
@@ -194,6 +321,8 @@ private:
 
 std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
 {
+    // The cursor iterates over the database, so it must have all coins.
+    Sync();
     auto i = std::make_unique<CCoinsViewDBCursor>(
         const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
     /* It seems that there are no "const iterators" for LevelDB.  Since we
@@ -296,17 +425,16 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nTime          = diskindex.nTime;
                 pindexNew->nBits          = diskindex.nBits;
                 pindexNew->nNonce         = diskindex.nNonce;
+                pindexNew->hashPoW        = diskindex.hashPoW;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
 
-                // FLO: Disable PoW Sanity check while loading block index from disk.
-                // We use the sha256 hash for the block index for performance reasons, which is recorded for later use.
-                // CheckProofOfWork() uses the scrypt hash which is discarded after a block is accepted.
-                // While it is technically feasible to verify the PoW, doing so takes several minutes as it
-                // requires recomputing every PoW hash during every FLO startup.
-                // We opt instead to simply trust the data that is on your local disk.
-                //if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
-                //    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+                // FLO: The block index is keyed by the sha256 hash, while CheckProofOfWork() needs the
+                // scrypt hash. Recomputing every scrypt hash would take several minutes on every startup,
+                // so PoW is only sanity checked for entries that have their scrypt hash stored; entries
+                // from older versions get it filled in by FillBlockIndexPoWHashes() in the background.
+                if ((pindexNew->nStatus & BLOCK_HAVE_POW_HASH) && !CheckProofOfWork(pindexNew->hashPoW, pindexNew->nBits, consensusParams))
+                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
 
                 pcursor->Next();
             } else {
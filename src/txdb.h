@@ -10,9 +10,14 @@
 #include <dbwrapper.h>
 #include <chain.h>
 #include <primitives/block.h>
+#include <sync.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -24,6 +29,8 @@ class uint256;
 static const int64_t nDefaultDbCache = 450;
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
+//! -backgroundflush default
+static const bool DEFAULT_BACKGROUND_FLUSH = false;
 //! max. -dbcache (MiB)
 static const int64_t nMaxDbCache = sizeof(void*) > 4 ? 16384 : 1024;
 //! min. -dbcache (MiB)
@@ -36,24 +43,44 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxTxIndexCache = 1024;
 //! Max memory allocated to all block filter index caches combined in MiB.
 static const int64_t max_filter_index_cache = 1024;
+//! Max memory allocated to the floData index cache in MiB.
+static const int64_t max_flodata_index_cache = 256;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
 
 // Actually declared in validation.cpp; can't include because of circular dependency.
 extern RecursiveMutex cs_main;
 
-/** CCoinsView backed by the coin database (chainstate/) */
+/**
+ * CCoinsView backed by the coin database (chainstate/)
+ *
+ * With background_flush, BatchWrite() hands the dirty coins to a writer thread
+ * and returns without waiting for them to be written. Until they are, the
+ * coins being written are served from memory, so the view always reflects the
+ * last BatchWrite(). Only one batch is written at a time. The database itself
+ * stays crash consistent through the head blocks marker that every write sets
+ * first and clears last.
+ *
+ * A batch that fails to be written stays readable from memory, as the caches
+ * above no longer have its coins, no further batches are accepted and the node
+ * is shut down.
+ */
 class CCoinsViewDB final : public CCoinsView
 {
 protected:
     std::unique_ptr<CDBWrapper> m_db;
     fs::path m_ldb_path;
     bool m_is_memory;
+    DBOptions m_db_options;
+
 public:
     /**
-     * @param[in] ldb_path    Location in the filesystem where leveldb data will be stored.
+     * @param[in] ldb_path          Location in the filesystem where leveldb data will be stored.
+     * @param[in] background_flush  Write batches of coins from a background thread.
+     * @param[in] db_options        LevelDB tuning of the database.
      */
-    explicit CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, bool fWipe);
+    explicit CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, bool fWipe, bool background_flush = false, const DBOptions& db_options = {});
+    ~CCoinsViewDB();
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
@@ -66,8 +93,47 @@ public:
     bool Upgrade();
     size_t EstimateSize() const override;
 
-    //! Dynamically alter the underlying leveldb cache size.
+    //! Dynamically alter the underlying leveldb cache size. This reopens the
+    //! database, so nothing may read from it without cs_main meanwhile.
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    //! Wait until the last batch passed to BatchWrite() is on disk. Returns false if writing any batch failed.
+    bool Sync() const;
+
+    //! Have the writer thread fail to write the next batch (for testing).
+    void SimulateWriteFailure() { WITH_LOCK(m_writer_mutex, m_simulate_write_failure = true); }
+
+    /**
+     * Number of times BatchWrite() was entered and left. It is odd while coins
+     * are being changed, and coins read while it stays even and unchanged are
+     * current. Can be read from any thread.
+     */
+    uint64_t GetWriteSequence() const { return m_write_sequence.load(); }
+
+private:
+    /** Coins handed to the writer thread, readable until they are written. */
+    struct PendingWrite {
+        CCoinsMapMemoryResource m_resource;
+        CCoinsMap m_coins{0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &m_resource};
+        uint256 m_best_block;
+    };
+
+    uint256 ReadBestBlock() const;
+    //! Write the dirty coins of a map without modifying it, so that it can be read concurrently.
+    bool WriteCoins(const CCoinsMap& mapCoins, const uint256& hashBlock);
+    //! Return the coin being written for an outpoint, if any.
+    const Coin* FindPendingCoin(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(m_writer_mutex);
+    void ThreadWrite();
+
+    mutable Mutex m_writer_mutex;
+    mutable std::condition_variable m_writer_cond;
+    std::unique_ptr<PendingWrite> m_pending GUARDED_BY(m_writer_mutex);
+    bool m_write_failed GUARDED_BY(m_writer_mutex){false};
+    bool m_simulate_write_failure GUARDED_BY(m_writer_mutex){false};
+    bool m_writer_stop GUARDED_BY(m_writer_mutex){false};
+    std::thread m_writer_thread;
+
+    std::atomic<uint64_t> m_write_sequence{0};
 };
 
 /** Access to the block database (blocks/index/) */
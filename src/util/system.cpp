@@ -1210,6 +1210,13 @@ void AllocateFileRange(FILE *file, unsigned int offset, unsigned int length) {
 #endif
 }
 
+void FileReadAhead(FILE* file, int64_t offset, int64_t length)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(fileno(file), offset, length, POSIX_FADV_WILLNEED);
+#endif
+}
+
 #ifdef WIN32
 fs::path GetSpecialFolderPath(int nFolder, bool fCreate)
 {
@@ -1378,6 +1385,19 @@ void ScheduleBatchPriority()
 #endif
 }
 
+void ScheduleIdlePriority()
+{
+#ifdef SCHED_IDLE
+    const static sched_param param{};
+    const int rc = pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+    if (rc != 0) {
+        LogPrintf("Failed to pthread_setschedparam: %s\n", strerror(rc));
+    }
+#else
+    ScheduleBatchPriority();
+#endif
+}
+
 namespace util {
 #ifdef WIN32
 WinCmdLineArgs::WinCmdLineArgs()
@@ -69,6 +69,11 @@ void DirectoryCommit(const fs::path &dirname);
 bool TruncateFile(FILE *file, unsigned int length);
 int RaiseFileDescriptorLimit(int nMinFD);
 void AllocateFileRange(FILE *file, unsigned int offset, unsigned int length);
+/**
+ * Advise the OS to start reading a range of a file into its cache in the
+ * background. A length of 0 means up to the end of the file. Advisory only.
+ */
+void FileReadAhead(FILE* file, int64_t offset, int64_t length);
 [[nodiscard]] bool RenameOver(fs::path src, fs::path dest);
 bool LockDirectory(const fs::path& directory, const std::string lockfile_name, bool probe_only=false);
 void UnlockDirectory(const fs::path& directory, const std::string& lockfile_name);
@@ -499,6 +504,13 @@ std::string CopyrightHolders(const std::string& strPrefix);
  */
 void ScheduleBatchPriority();
 
+/**
+ * On platforms that support it, tell the kernel to only run the calling
+ * thread when the CPU would otherwise be idle. See SCHED_IDLE in sched(7).
+ * Elsewhere, fall back to ScheduleBatchPriority().
+ */
+void ScheduleIdlePriority();
+
 namespace util {
 
 //! Simplification of std insertion
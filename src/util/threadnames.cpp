@@ -13,6 +13,7 @@
 #include <pthread_np.h>
 #endif
 
+#include <crypto/scrypt.h>
 #include <util/threadnames.h>
 
 #ifdef HAVE_SYS_PRCTL_H
@@ -57,10 +58,12 @@ static void SetInternalName(std::string name) { }
 void util::ThreadRename(std::string&& name)
 {
     SetThreadName(("b-" + name).c_str());
+    ScryptSetThreadName(name);
     SetInternalName(std::move(name));
 }
 
 void util::ThreadSetInternalName(std::string&& name)
 {
+    ScryptSetThreadName(name);
     SetInternalName(std::move(name));
 }
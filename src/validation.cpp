@@ -1177,7 +1177,9 @@ CoinsViews::CoinsViews(
     size_t cache_size_bytes,
     bool in_memory,
     bool should_wipe) : m_dbview(
-                            gArgs.GetDataDirNet() / ldb_name, cache_size_bytes, in_memory, should_wipe),
+                            gArgs.GetDataDirNet() / ldb_name, cache_size_bytes, in_memory, should_wipe,
+                            gArgs.GetBoolArg("-backgroundflush", DEFAULT_BACKGROUND_FLUSH),
+                            ReadDBOptions(gArgs, "chainstate")),
                         m_catcherview(&m_dbview) {}
 
 void CoinsViews::InitCache()
@@ -2122,6 +2124,11 @@ bool CChainState::FlushStateToDisk(
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
+                // A coins write still in progress may need these blocks for
+                // replay after a crash.
+                if (!CoinsDB().Sync()) {
+                    return AbortNode(state, "Failed to write to coin database");
+                }
                 UnlinkPrunedFiles(setFilesToPrune);
             }
             nLastWrite = nNow;
@@ -2140,8 +2147,21 @@ bool CChainState::FlushStateToDisk(
                 return AbortNode(state, "Disk space is too low!", _("Disk space is too low!"));
             }
             // Flush the chainstate (which may refer to block index entries).
-            if (!CoinsTip().Flush())
+            // Flushes only done to bound the cache keep the recently used
+            // coins, so that validation doesn't continue with a cold cache.
+            // With -backgroundflush the coins are written while validation
+            // continues, except for explicit and pruning flushes, which wait.
+            const int64_t keep_percent = std::clamp<int64_t>(gArgs.GetArg("-dbcachekeep", DEFAULT_DBCACHE_KEEP), 0, MAX_DBCACHE_KEEP);
+            if (mode != FlushStateMode::ALWAYS && !fFlushForPrune && keep_percent > 0) {
+                if (!CoinsTip().PartialFlush(m_coinstip_cache_size_bytes / 100 * keep_percent)) {
+                    return AbortNode(state, "Failed to write to coin database");
+                }
+            } else if (!CoinsTip().Flush()) {
+                return AbortNode(state, "Failed to write to coin database");
+            }
+            if ((mode == FlushStateMode::ALWAYS || fFlushForPrune) && !CoinsDB().Sync()) {
                 return AbortNode(state, "Failed to write to coin database");
+            }
             nLastFlush = nNow;
             full_flush_completed = true;
         }
@@ -2364,6 +2384,13 @@ bool CChainState::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew
     int64_t nTime3;
     LogPrint(BCLog::BENCH, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDisk * MICRO);
     {
+        // Have the coins the block spends in the cache before looking them up.
+        if (g_block_prefetch > 0) {
+            if (!m_coin_prefetcher) {
+                m_coin_prefetcher = std::make_unique<CoinPrefetcher>(CoinsDB(), COIN_PREFETCH_THREADS);
+            }
+            m_coin_prefetcher->WarmCache(blockConnecting, CoinsTip());
+        }
         CCoinsViewCache view(&CoinsTip());
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view);
         GetMainSignals().BlockChecked(blockConnecting, state);
@@ -2553,9 +2580,45 @@ bool CChainState::ActivateBestChainStep(BlockValidationState& state, CBlockIndex
         }
         nHeight = nTargetHeight;
 
+        // Have the blocks after the one being connected read and checked in
+        // the background, keeping a window of them ahead of the tip.
+        if (vpindexToConnect.size() > 1 && g_block_prefetch > 0 && !m_block_prefetcher) {
+            if (!m_coin_prefetcher) {
+                m_coin_prefetcher = std::make_unique<CoinPrefetcher>(CoinsDB(), COIN_PREFETCH_THREADS);
+            }
+            // Destroyed before m_coin_prefetcher, which it uses.
+            CoinPrefetcher* coin_prefetcher = m_coin_prefetcher.get();
+            m_block_prefetcher = std::make_unique<BlockPrefetcher>(m_params.GetConsensus(), BLOCK_CONNECT_PIPELINE_THREADS, [this, coin_prefetcher](const CBlock& block) {
+                // Caches the result in block.fChecked, so ConnectBlock() skips it.
+                BlockValidationState dummy;
+                if (CheckBlock(block, dummy, m_params.GetConsensus())) {
+                    coin_prefetcher->PrefetchBlock(block);
+                }
+            });
+        }
+
         // Connect new blocks.
         for (CBlockIndex* pindexConnect : reverse_iterate(vpindexToConnect)) {
-            if (!ConnectTip(state, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, disconnectpool)) {
+            std::shared_ptr<const CBlock> pblockConnect;
+            if (pindexConnect == pindexMostWork && pblock) {
+                pblockConnect = pblock;
+            } else if (m_block_prefetcher) {
+                pblockConnect = m_block_prefetcher->Get(pindexConnect->GetBlockHash());
+            }
+            if (m_block_prefetcher) {
+                // Slide the window past this block. The blocks in it stay
+                // queued across calls, as each call usually connects only one.
+                std::vector<BlockPrefetcher::BlockRef> prefetch;
+                const int window_end = std::min(pindexConnect->nHeight + g_block_prefetch, pindexMostWork->nHeight);
+                for (int height = pindexConnect->nHeight + 1; height <= window_end; ++height) {
+                    const CBlockIndex* pindex = pindexMostWork->GetAncestor(height);
+                    if (pindex == pindexMostWork && pblock) break;
+                    if (!(pindex->nStatus & BLOCK_HAVE_DATA)) break;
+                    prefetch.emplace_back(pindex->GetBlockHash(), pindex->GetBlockPos());
+                }
+                m_block_prefetcher->Prefetch(prefetch);
+            }
+            if (!ConnectTip(state, pindexConnect, pblockConnect, connectTrace, disconnectpool)) {
                 if (state.IsInvalid()) {
                     // The block violates a consensus rule.
                     if (state.GetResult() != BlockValidationResult::BLOCK_MUTATED) {
@@ -3295,7 +3358,7 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     return true;
 }
 
-bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3314,7 +3377,7 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus())) {
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPOW)) {
             LogPrint(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -3381,16 +3444,60 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
     return true;
 }
 
+/**
+ * Check the proof of work of the headers that are not in the block index yet,
+ * without holding cs_main for the scrypt computations.
+ * Returns, for each header, its proof-of-work hash if it has been verified.
+ */
+static std::vector<std::optional<uint256>> CheckBlockHeadersPoW(Span<const CBlockHeader> headers, const BlockManager& blockman, const Consensus::Params& consensusParams) LOCKS_EXCLUDED(cs_main)
+{
+    std::vector<size_t> unknown;
+    std::vector<CBlockHeader> batch;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < headers.size(); ++i) {
+            if (!blockman.LookupBlockIndex(headers[i].GetHash())) {
+                unknown.push_back(i);
+                batch.push_back(headers[i]);
+            }
+        }
+    }
+
+    std::vector<std::optional<uint256>> checked(headers.size());
+    const std::vector<uint256> pow_hashes = GetPoWHashes(batch);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (CheckProofOfWork(pow_hashes[i], batch[i].nBits, consensusParams)) {
+            checked[unknown[i]] = pow_hashes[i];
+        }
+    }
+    return checked;
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
     AssertLockNotHeld(cs_main);
-    {
+    // The headers are hashed in chunks, each only after all headers before it
+    // were accepted. The chunks double in size, starting from a single header,
+    // so that a peer sending invalid headers makes us compute at most about
+    // as many hashes as it sent valid headers, plus one.
+    size_t chunk_size = 1;
+    for (size_t begin = 0; begin < headers.size(); begin += chunk_size, chunk_size *= 2) {
+        chunk_size = std::min(chunk_size, headers.size() - begin);
+        const Span<const CBlockHeader> chunk = Span<const CBlockHeader>{headers}.subspan(begin, chunk_size);
+        // Headers whose proof of work failed here (or that were already known)
+        // are checked again below, so that failures are reported exactly as before.
+        const std::vector<std::optional<uint256>> pow_hashes = CheckBlockHeadersPoW(chunk, m_blockman, chainparams.GetConsensus());
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            const CBlockHeader& header = chunk[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
             bool accepted = m_blockman.AcceptBlockHeader(
-                header, state, chainparams, &pindex);
+                header, state, chainparams, &pindex, /* fCheckPOW */ !pow_hashes[i]);
+            if (accepted && pow_hashes[i] && !(pindex->nStatus & BLOCK_HAVE_POW_HASH)) {
+                pindex->SetBlockPoWHash(*pow_hashes[i]);
+                setDirtyBlockIndex.insert(pindex);
+            }
             ActiveChainstate().CheckBlockIndex();
 
             if (!accepted) {
@@ -4491,6 +4598,9 @@ bool CChainState::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
     size_t old_coinstip_size = m_coinstip_cache_size_bytes;
     m_coinstip_cache_size_bytes = coinstip_size;
     m_coinsdb_cache_size_bytes = coinsdb_size;
+    // Its workers read the coins database without cs_main, so stop them
+    // before the database is reopened. It is recreated when next needed.
+    m_block_prefetcher.reset();
     CoinsDB().ResizeCache(coinsdb_size);
 
     LogPrintf("[%s] resized coinsdb cache to %.1f MiB\n",
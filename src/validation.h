@@ -17,6 +17,8 @@
 #include <consensus/validation.h>
 #include <crypto/common.h> // for ReadLE64
 #include <fs.h>
+#include <node/blockprefetcher.h>
+#include <node/coinprefetcher.h>
 #include <node/utxo_snapshot.h>
 #include <policy/feerate.h>
 #include <policy/packages.h>
@@ -73,16 +75,25 @@ static const unsigned int DEFAULT_DESCENDANT_SIZE_LIMIT = 101;
 /** Default for -mempoolexpiry, expiration time for mempool transactions in hours */
 static const unsigned int DEFAULT_MEMPOOL_EXPIRY = 336;
 /** Maximum number of dedicated script-checking threads allowed */
-static const int MAX_SCRIPTCHECK_THREADS = 15;
+static const int MAX_SCRIPTCHECK_THREADS = 256;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Number of threads reading and checking blocks ahead of the one being connected */
+static const int BLOCK_CONNECT_PIPELINE_THREADS = 2;
+/** Number of threads reading the coins spent by the block being connected */
+static const int COIN_PREFETCH_THREADS = 4;
 static const int64_t DEFAULT_MAX_TIP_AGE = 24 * 60 * 60;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = false;
 static constexpr bool DEFAULT_COINSTATSINDEX{false};
+static constexpr bool DEFAULT_FLODATAINDEX{false};
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
+/** Default for -dbcachekeep, the percentage of the coins cache kept after periodic and size triggered flushes */
+static const int DEFAULT_DBCACHE_KEEP = 0;
+/** Maximum for -dbcachekeep, leaving room for the cache to grow before it is flushed again */
+static const int MAX_DBCACHE_KEEP = 80;
 /** Default for -stopatheight */
 static const int DEFAULT_STOPATHEIGHT = 0;
 /** Block files containing a block-height within MIN_BLOCKS_TO_KEEP of ::ChainActive().Tip() will not be pruned. */
@@ -467,12 +478,15 @@ public:
     /**
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to m_block_index.
+     * fCheckPOW may only be false if the caller has already checked the header's
+     * proof of work.
      */
     bool AcceptBlockHeader(
         const CBlockHeader& block,
         BlockValidationState& state,
         const CChainParams& chainparams,
-        CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+        CBlockIndex** ppindex,
+        bool fCheckPOW = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     CBlockIndex* LookupBlockIndex(const uint256& hash) const EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -590,6 +604,14 @@ protected:
     //! Manages the UTXO set, which is a reflection of the contents of `m_chain`.
     std::unique_ptr<CoinsViews> m_coins_views;
 
+    //! Reads the coins spent by blocks about to be connected. Created on
+    //! first use by ActivateBestChainStep() or ConnectTip().
+    std::unique_ptr<CoinPrefetcher> m_coin_prefetcher GUARDED_BY(::cs_main);
+
+    //! Reads and checks the next blocks to connect while the tip is being
+    //! extended. Created on first use by ActivateBestChainStep().
+    std::unique_ptr<BlockPrefetcher> m_block_prefetcher GUARDED_BY(::cs_main);
+
 public:
     //! Reference to a BlockManager instance which itself is shared across all
     //! CChainState instances.
@@ -661,7 +683,13 @@ public:
     }
 
     //! Destructs all objects related to accessing the UTXO set.
-    void ResetCoinsViews() { m_coins_views.reset(); }
+    void ResetCoinsViews() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        // The prefetchers read from the coins database.
+        m_block_prefetcher.reset();
+        m_coin_prefetcher.reset();
+        m_coins_views.reset();
+    }
 
     //! The cache size of the on-disk coins view.
     size_t m_coinsdb_cache_size_bytes{0};
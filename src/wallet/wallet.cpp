@@ -1598,6 +1598,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     double progress_end = chain().guessVerificationProgress(end_hash);
     double progress_current = progress_begin;
     int block_height = start_height;
+    std::unique_ptr<interfaces::BlockReader> block_reader = chain().makeBlockReader();
     while (!fAbortRescan && !chain().shutdownRequested()) {
         if (progress_end - progress_begin > 0.0) {
             m_scanning_progress = (progress_current - progress_begin) / (progress_end - progress_begin);
@@ -1614,7 +1615,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
 
         // Read block data
         CBlock block;
-        chain().findBlock(block_hash, FoundBlock().data(block));
+        block_reader->readBlock(block_hash, block);
 
         // Find next block separately from reading data above, because reading
         // is slow and there might be a reorg while it is read.
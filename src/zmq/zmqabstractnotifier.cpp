@@ -42,3 +42,8 @@ bool CZMQAbstractNotifier::NotifyTransactionRemoval(const CTransaction &/*transa
 {
     return true;
 }
+
+bool CZMQAbstractNotifier::NotifyFloData(const CTransaction &/*transaction*/, const CBlockIndex * /*CBlockIndex*/)
+{
+    return true;
+}
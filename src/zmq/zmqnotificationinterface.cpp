@@ -37,6 +37,7 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubsequence"] = CZMQAbstractNotifier::Create<CZMQPublishSequenceNotifier>;
+    factories["pubflodata"] = CZMQAbstractNotifier::Create<CZMQPublishFloDataNotifier>;
 
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
     for (const auto& entry : factories)
@@ -48,6 +49,9 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
             notifier->SetType(entry.first);
             notifier->SetAddress(address);
             notifier->SetOutboundMessageHighWaterMark(static_cast<int>(gArgs.GetArg(arg + "hwm", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM)));
+            if (auto flo_data_notifier = dynamic_cast<CZMQPublishFloDataNotifier*>(notifier.get())) {
+                flo_data_notifier->SetPrefixes(gArgs.GetArgs(arg + "prefix"));
+            }
             notifiers.push_back(std::move(notifier));
         }
     }
@@ -144,7 +148,8 @@ void CZMQNotificationInterface::TransactionAddedToMempool(const CTransactionRef&
     const CTransaction& tx = *ptx;
 
     TryForEachAndRemoveFailed(notifiers, [&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyTransaction(tx) && notifier->NotifyTransactionAcceptance(tx, mempool_sequence);
+        return notifier->NotifyTransaction(tx) && notifier->NotifyTransactionAcceptance(tx, mempool_sequence) &&
+               notifier->NotifyFloData(tx, nullptr);
     });
 }
 
@@ -162,8 +167,8 @@ void CZMQNotificationInterface::BlockConnected(const std::shared_ptr<const CBloc
 {
     for (const CTransactionRef& ptx : pblock->vtx) {
         const CTransaction& tx = *ptx;
-        TryForEachAndRemoveFailed(notifiers, [&tx](CZMQAbstractNotifier* notifier) {
-            return notifier->NotifyTransaction(tx);
+        TryForEachAndRemoveFailed(notifiers, [&tx, pindexConnected](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyTransaction(tx) && notifier->NotifyFloData(tx, pindexConnected);
         });
     }
 
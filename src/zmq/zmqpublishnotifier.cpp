@@ -15,8 +15,10 @@
 
 #include <zmq.h>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstddef>
+#include <limits>
 #include <map>
 #include <optional>
 #include <string>
@@ -29,6 +31,7 @@ static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_FLODATA   = "flodata";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -269,3 +272,30 @@ bool CZMQPublishSequenceNotifier::NotifyTransactionRemoval(const CTransaction &t
     LogPrint(BCLog::ZMQ, "zmq: Publish hashtx mempool removal %s to %s\n", hash.GetHex(), this->address);
     return SendSequenceMsg(*this, hash, /* Mempool (R)emoval */ 'R', mempool_sequence);
 }
+
+// Send a 'flodata' topic message with the following structure:
+//    <32-byte txid> | <32-byte block hash> | <4-byte LE height> | <floData>
+// Mempool transactions have an all-zero block hash and a height of 0xffffffff.
+bool CZMQPublishFloDataNotifier::NotifyFloData(const CTransaction &transaction, const CBlockIndex *pindex)
+{
+    const std::string& flo_data = transaction.strFloData;
+    if (flo_data.empty()) return true;
+    if (!m_prefixes.empty() && std::none_of(m_prefixes.begin(), m_prefixes.end(), [&](const std::string& prefix) {
+            return flo_data.compare(0, prefix.size(), prefix) == 0;
+        })) {
+        return true;
+    }
+
+    const uint256 hash = transaction.GetHash();
+    const uint256 block_hash = pindex ? pindex->GetBlockHash() : uint256();
+    LogPrint(BCLog::ZMQ, "zmq: Publish flodata %s to %s\n", hash.GetHex(), this->address);
+
+    std::vector<unsigned char> data(sizeof(hash) + sizeof(block_hash) + sizeof(uint32_t) + flo_data.size());
+    for (unsigned int i = 0; i < sizeof(hash); ++i) {
+        data[sizeof(hash) - 1 - i] = hash.begin()[i];
+        data[sizeof(hash) + sizeof(block_hash) - 1 - i] = block_hash.begin()[i];
+    }
+    WriteLE32(data.data() + sizeof(hash) + sizeof(block_hash), pindex ? pindex->nHeight : std::numeric_limits<uint32_t>::max());
+    std::copy(flo_data.begin(), flo_data.end(), data.begin() + sizeof(hash) + sizeof(block_hash) + sizeof(uint32_t));
+    return SendZmqMessage(MSG_FLODATA, data.data(), data.size());
+}
@@ -7,6 +7,9 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <string>
+#include <vector>
+
 class CBlockIndex;
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
@@ -61,4 +64,15 @@ public:
     bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence) override;
 };
 
+class CZMQPublishFloDataNotifier : public CZMQAbstractPublishNotifier
+{
+private:
+    //! Only publish floData starting with one of these; publish all floData if empty
+    std::vector<std::string> m_prefixes;
+
+public:
+    void SetPrefixes(std::vector<std::string> prefixes) { m_prefixes = std::move(prefixes); }
+    bool NotifyFloData(const CTransaction &transaction, const CBlockIndex *pindex) override;
+};
+
 #endif // FLOCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
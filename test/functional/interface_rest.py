@@ -43,7 +43,7 @@ class RESTTest (FlocoinTestFramework):
     def set_test_params(self):
         self.setup_clean_chain = True
         self.num_nodes = 2
-        self.extra_args = [["-rest"], []]
+        self.extra_args = [["-rest", "-blockfilterindex=flodata"], []]
         self.supports_cli = False
 
     def skip_test_if_missing_module(self):
@@ -265,6 +265,51 @@ class RESTTest (FlocoinTestFramework):
         assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid height: -1")
         self.test_rest_request("/blockhashbyheight/", ret_type=RetType.OBJ, status=400)
 
+        self.log.info("Test the /flodata URI")
+        flodata_hash = self.nodes[0].generatetoaddress(1, self.nodes[0].get_deterministic_priv_key().address, 1000000, "text:rest")[0]
+        flodata_block = self.nodes[0].getblock(flodata_hash, 2)
+        flodata_tx = flodata_block['tx'][0]
+        json_obj = self.test_rest_request("/flodata/{}/1".format(flodata_block['height']))
+        assert_equal(json_obj, [{'txid': flodata_tx['txid'], 'height': flodata_block['height'], 'vouts': len(flodata_tx['vout']), 'floData': 'text:rest'}])
+
+        resp_bytes = self.test_rest_request("/flodata/{}/1".format(flodata_block['height']), req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(resp_bytes[:32][::-1].hex(), flodata_tx['txid'])
+        assert_equal(int.from_bytes(resp_bytes[32:36], 'little'), flodata_block['height'])
+        assert_equal(resp_bytes[36], len(flodata_tx['vout']))
+        assert_equal(resp_bytes[37:], b'\x09text:rest')
+
+        # Blocks without floData are skipped
+        assert_equal(self.test_rest_request("/flodata/1/1"), [])
+        resp = self.test_rest_request("/flodata/1000000/1", ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block height out of range")
+        resp = self.test_rest_request("/flodata/0/1001", ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block count out of range: 1001")
+        self.test_rest_request("/flodata/0", ret_type=RetType.OBJ, status=400)
+
+        self.log.info("Test the /blockfilter and /blockfilterheaders URIs")
+        self.wait_until(lambda: self.nodes[0].getindexinfo()['flodata block filter index']['synced'])
+        rpc_filter = self.nodes[0].getblockfilter(flodata_hash, 'flodata')
+        json_obj = self.test_rest_request("/blockfilter/flodata/{}".format(flodata_hash))
+        assert_equal(json_obj, {'filter': rpc_filter['filter']})
+        resp_bytes = self.test_rest_request("/blockfilter/flodata/{}".format(flodata_hash), req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(resp_bytes[0], 0x80)
+        assert_equal(resp_bytes[1:33][::-1].hex(), flodata_hash)
+        assert_equal(resp_bytes[34:].hex(), rpc_filter['filter'])
+
+        prev_hash = flodata_block['previousblockhash']
+        json_obj = self.test_rest_request("/blockfilterheaders/flodata/2/{}".format(prev_hash))
+        assert_equal(json_obj, [self.nodes[0].getblockfilter(prev_hash, 'flodata')['header'], rpc_filter['header']])
+        resp_bytes = self.test_rest_request("/blockfilterheaders/flodata/1/{}".format(flodata_hash), req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(resp_bytes[::-1].hex(), rpc_filter['header'])
+
+        resp = self.test_rest_request("/blockfilter/basic/{}".format(flodata_hash), ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Index is not enabled for filtertype basic")
+        resp = self.test_rest_request("/blockfilter/unknown/{}".format(flodata_hash), ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Unknown filtertype unknown")
+        resp = self.test_rest_request("/blockfilterheaders/flodata/2001/{}".format(flodata_hash), ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Header count out of range: 2001")
+        self.test_rest_request("/blockfilter/flodata/0000000000000000000000000000000000000000000000000000000000000000", ret_type=RetType.OBJ, status=404)
+
         # Compare with json block header
         json_obj = self.test_rest_request("/headers/1/{}".format(bb_hash))
         assert_equal(len(json_obj), 1)  # ensure that there is one header in the json response
@@ -83,7 +83,8 @@ class ZMQTestSetupBlock:
     """
 
     def __init__(self, node):
-        self.block_hash = node.generate(1)[0]
+        # The coinbase carries floData, so that flodata subscribers are notified too.
+        self.block_hash = node.generatetoaddress(1, node.get_deterministic_priv_key().address, 1000000, "zmq:sync")[0]
         coinbase = node.getblock(self.block_hash, 2)['tx'][0]
         self.tx_hash = coinbase['txid']
         self.raw_tx = coinbase['hex']
@@ -115,6 +116,7 @@ class ZMQTest (FlocoinTestFramework):
         self.ctx = zmq.Context()
         try:
             self.test_basic()
+            self.test_flodata()
             self.test_sequence()
             self.test_mempool_sync()
             self.test_reorg()
@@ -126,14 +128,14 @@ class ZMQTest (FlocoinTestFramework):
 
     # Restart node with the specified zmq notifications enabled, subscribe to
     # all of them and return the corresponding ZMQSubscriber objects.
-    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True):
+    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True, extra_args=[]):
         subscribers = []
         for topic, address in services:
             socket = self.ctx.socket(zmq.SUB)
             subscribers.append(ZMQSubscriber(socket, topic.encode()))
 
         self.restart_node(0, ["-zmqpub%s=%s" % (topic, address) for topic, address in services] +
-                             self.extra_args[0])
+                             self.extra_args[0] + extra_args)
 
         for i, sub in enumerate(subscribers):
             sub.socket.connect(services[i][1])
@@ -242,6 +244,40 @@ class ZMQTest (FlocoinTestFramework):
 
         assert_equal(self.nodes[1].getzmqnotifications(), [])
 
+    def test_flodata(self):
+        self.log.info("Test the flodata notification")
+        address = 'tcp://127.0.0.1:28336'
+        flodata = self.setup_zmq_test([("flodata", address)], extra_args=["-zmqpubflodataprefix=zmq:"])[0]
+
+        def receive_flodata():
+            body = flodata.receive()
+            return body[:32].hex(), body[32:64].hex(), struct.unpack('<I', body[64:68])[0], body[68:]
+
+        self.log.info("FloData of connected blocks is published")
+        block_hash = self.nodes[0].generatetoaddress(1, ADDRESS_BCRT1_UNSPENDABLE, 1000000, "zmq:block")[0]
+        block = self.nodes[0].getblock(block_hash)
+        assert_equal(receive_flodata(), (block["tx"][0], block_hash, block["height"], b"zmq:block"))
+
+        self.log.info("FloData not starting with a configured prefix is not published")
+        self.nodes[0].generatetoaddress(1, ADDRESS_BCRT1_UNSPENDABLE, 1000000, "other:block")
+        block_hash = self.nodes[0].generatetoaddress(1, ADDRESS_BCRT1_UNSPENDABLE, 1000000, "zmq:after")[0]
+        block = self.nodes[0].getblock(block_hash)
+        assert_equal(receive_flodata(), (block["tx"][0], block_hash, block["height"], b"zmq:after"))
+
+        if self.is_wallet_compiled():
+            self.log.info("FloData of mempool transactions is published, and again when they are mined")
+            payment_txid = self.nodes[1].sendtoaddress(address=self.nodes[0].getnewaddress(), amount=1.0, floData="zmq:mempool")
+            self.sync_mempools()
+            assert_equal(receive_flodata(), (payment_txid, "00" * 32, 0xffffffff, b"zmq:mempool"))
+            block_hash = self.nodes[0].generatetoaddress(1, ADDRESS_BCRT1_UNSPENDABLE)[0]
+            block = self.nodes[0].getblock(block_hash)
+            assert_equal(receive_flodata(), (payment_txid, block_hash, block["height"], b"zmq:mempool"))
+            self.sync_blocks()
+
+        assert_equal(self.nodes[0].getzmqnotifications(), [
+            {"type": "pubflodata", "address": address, "hwm": 1000},
+        ])
+
     def test_reorg(self):
         if not self.is_wallet_compiled():
             self.log.info("Skipping reorg test because wallet is disabled")